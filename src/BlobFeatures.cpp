@@ -0,0 +1,168 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "BlobFeatures.h"
+
+#include <climits>
+#include <cmath>
+
+//--------------------------------------------------------------
+
+static void computePos(BlobFeatures &blob, float *out) {
+    out[0] = blob.pos.x;
+    out[1] = blob.pos.y;
+    out[2] = blob.pos.z;
+}
+
+static void computeVel(BlobFeatures &blob, float *out) {
+    out[0] = blob.vel.x;
+    out[1] = blob.vel.y;
+    out[2] = blob.vel.z;
+}
+
+static void computeAcc(BlobFeatures &blob, float *out) {
+    out[0] = blob.acc.x;
+    out[1] = blob.acc.y;
+    out[2] = blob.acc.z;
+}
+
+/**
+ * Angle of the major axis, normalized from [-pi/2, pi/2] to [0, 1].
+ */
+static void computeOrientation(BlobFeatures &blob, float *out) {
+    const double theta = 0.5 * atan2(2.0 * blob.mu.mu11, blob.mu.mu20 - blob.mu.mu02);
+    out[0] = static_cast<float>(theta / PI + 0.5);
+}
+
+/**
+ * Bounding box x, y, width and height, normalized to the frame size.
+ */
+static void computeBoundingBox(BlobFeatures &blob, float *out) {
+    const cv::Rect &r = blob.getBoundingRect();
+    out[0] = static_cast<float>(r.x) / blob.rgb.cols;
+    out[1] = static_cast<float>(r.y) / blob.rgb.rows;
+    out[2] = static_cast<float>(r.width) / blob.rgb.cols;
+    out[3] = static_cast<float>(r.height) / blob.rgb.rows;
+}
+
+/**
+ * Eccentricity of the ellipse with the same second order moments, 0 for a circle, towards 1 for a line.
+ */
+static void computeEccentricity(BlobFeatures &blob, float *out) {
+    const double a = blob.mu.mu20 + blob.mu.mu02;
+    const double d = sqrt(4.0 * blob.mu.mu11 * blob.mu.mu11 + (blob.mu.mu20 - blob.mu.mu02) * (blob.mu.mu20 - blob.mu.mu02));
+    const double l1 = a + d;
+    const double l2 = a - d;
+    out[0] = l1 > 0.0 ? static_cast<float>(sqrt(1.0 - l2 / l1)) : 0.0f;
+}
+
+static void computeHuMoments(BlobFeatures &blob, float *out) {
+    double hu[7];
+    cv::HuMoments(blob.mu, hu);
+    for (int i = 0; i < 7; i++) {
+        // The raw moments span many orders of magnitude, send -sign(h) * log10|h| to bring them to a similar range.
+        out[i] = hu[i] == 0.0 ? 0.0f : static_cast<float>(-std::copysign(1.0, hu[i]) * std::log10(std::abs(hu[i])));
+    }
+}
+
+/**
+ * Mean colour (r, g, b) inside the contour, normalized to [0, 1].
+ */
+static void computeColorMean(BlobFeatures &blob, float *out) {
+    const cv::Rect r = blob.getBoundingRect() & cv::Rect(0, 0, blob.rgb.cols, blob.rgb.rows);
+    if (r.area() == 0) {
+        out[0] = out[1] = out[2] = 0.0f;
+        return;
+    }
+    // Rasterize the contour only within its bounding box.
+    cv::Mat mask = cv::Mat::zeros(r.size(), CV_8UC1);
+    const std::vector<std::vector<cv::Point>> contours(1, blob.contour);
+    cv::drawContours(mask, contours, 0, cv::Scalar(255), cv::FILLED, cv::LINE_8, cv::noArray(), INT_MAX, -r.tl());
+    const cv::Scalar mean = cv::mean(blob.rgb(r), mask);
+    out[0] = static_cast<float>(mean[0] / 255.0);
+    out[1] = static_cast<float>(mean[1] / 255.0);
+    out[2] = static_cast<float>(mean[2] / 255.0);
+}
+
+/**
+ * Ratio of the contour area to the area of its convex hull, 1 for a convex blob.
+ */
+static void computeConvexity(BlobFeatures &blob, float *out) {
+    const double hull_area = cv::contourArea(blob.getHull());
+    out[0] = hull_area > 0.0 ? static_cast<float>(blob.mu.m00 / hull_area) : 0.0f;
+}
+
+//--------------------------------------------------------------
+
+BlobFeatures::BlobFeatures(const std::vector<cv::Point> &contour, const cv::Moments &mu, const cv::Mat &rgb,
+                           const ofVec3f &pos, const ofVec3f &vel, const ofVec3f &acc)
+        : contour(contour), mu(mu), rgb(rgb), pos(pos), vel(vel), acc(acc) {
+}
+
+const std::vector<BlobFeatures::Extractor> &BlobFeatures::registry() {
+    static const std::vector<Extractor> extractors = {
+            {"pos",          3, computePos},
+            {"vel",          3, computeVel},
+            {"acc",          3, computeAcc},
+            {"orientation",  1, computeOrientation},
+            {"bbox",         4, computeBoundingBox},
+            {"eccentricity", 1, computeEccentricity},
+            {"hu",           7, computeHuMoments},
+            {"color",        3, computeColorMean},
+            {"convexity",    1, computeConvexity}
+    };
+    return extractors;
+}
+
+/**
+ * Parses a comma separated list of feature names. Unknown names are logged and skipped.
+ */
+std::vector<const BlobFeatures::Extractor *> BlobFeatures::parseSchema(const std::string &schema) {
+    std::vector<const Extractor *> selected;
+    for (const std::string &name : ofSplitString(schema, ",", true, true)) {
+        const auto &r = registry();
+        const auto it = std::find_if(r.begin(), r.end(), [&](const Extractor &e) { return name == e.name; });
+        if (it == r.end()) {
+            ofLog(OF_LOG_WARNING, "Unknown feature \"" + name + "\" in OSC schema.");
+            continue;
+        }
+        selected.push_back(&*it);
+    }
+    return selected;
+}
+
+int BlobFeatures::schemaSize(const std::vector<const Extractor *> &schema) {
+    int n = 0;
+    for (const Extractor *e : schema) {
+        n += e->size;
+    }
+    return n;
+}
+
+/**
+ * Returns the schema as a comma separated list of the selected feature names.
+ */
+std::string BlobFeatures::schemaName(const std::vector<const Extractor *> &schema) {
+    std::string name;
+    for (const Extractor *e : schema) {
+        name += (name.empty() ? "" : ",") + std::string(e->name);
+    }
+    return name;
+}
+
+const cv::Rect &BlobFeatures::getBoundingRect() {
+    if (!has_bounding_rect) {
+        bounding_rect = cv::boundingRect(contour);
+        has_bounding_rect = true;
+    }
+    return bounding_rect;
+}
+
+const std::vector<cv::Point> &BlobFeatures::getHull() {
+    if (!has_hull) {
+        cv::convexHull(contour, hull);
+        has_hull = true;
+    }
+    return hull;
+}
@@ -0,0 +1,56 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxCv.h"
+
+/**
+ * Extended features of a single blob, computed on demand for the blobs that are actually sent.
+ *
+ * Features are selected by name in the OSC schema, e.g. "pos,vel,acc,orientation,bbox". Each feature is
+ * computed only if it is in the schema. Intermediate results that several features need, like the bounding
+ * box and the convex hull, are computed once per blob; the moments come from find_blobs().
+ */
+class BlobFeatures {
+
+public:
+
+    struct Extractor {
+        const char *name;
+        int size;
+        void (*compute)(BlobFeatures &blob, float *out);
+    };
+
+    BlobFeatures(const std::vector<cv::Point> &contour, const cv::Moments &mu, const cv::Mat &rgb,
+                 const ofVec3f &pos, const ofVec3f &vel, const ofVec3f &acc);
+
+    static const std::vector<Extractor> &registry();
+
+    static std::vector<const Extractor *> parseSchema(const std::string &schema);
+
+    static int schemaSize(const std::vector<const Extractor *> &schema);
+
+    static std::string schemaName(const std::vector<const Extractor *> &schema);
+
+    const cv::Rect &getBoundingRect();
+
+    const std::vector<cv::Point> &getHull();
+
+    const std::vector<cv::Point> &contour;
+    const cv::Moments &mu;
+    const cv::Mat &rgb;
+    const ofVec3f &pos;
+    const ofVec3f &vel;
+    const ofVec3f &acc;
+
+private:
+
+    bool has_bounding_rect = false;
+    cv::Rect bounding_rect;
+    bool has_hull = false;
+    std::vector<cv::Point> hull;
+
+};
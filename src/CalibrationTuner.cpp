@@ -0,0 +1,340 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "CalibrationTuner.h"
+
+#include <algorithm>
+#include <ctime>
+#include <fstream>
+#include <sstream>
+
+#include <pthread.h>
+
+#include <opencv2/imgproc.hpp>
+
+#ifdef __APPLE__
+#include <pthread/qos.h>
+#endif
+
+#include "ColorFilter.h"
+#include "FrameFileSource.h"
+
+// Search space, within the ranges of the sliders in the Calibration panel.
+static const int RADII[] = {4, 8, 12, 16, 20};
+static const int TOL_H[] = {0, 1, 2, 3, 5, 8, 12, 20};
+static const int TOL_S[] = {0, 5, 10, 15, 25, 40, 60};
+static const int TOL_V[] = {0, 10, 20, 40, 60, 80};
+static const size_t MIN_AREA[] = {10, 50, 100, 200, 400, 800, 1600};
+static const float MAX_AREA_FRACTION[] = {0.05f, 0.1f, 0.25f, 0.5f};
+
+// A detection counts as a hit when it is this close to the label, in normalized coordinates.
+static const float MAX_LABEL_DISTANCE = 0.05f;
+
+// Score penalty per millisecond of filter and contour cost per frame.
+static const float COST_WEIGHT = 0.01f;
+
+/**
+ * Returns the CPU time of the calling thread. The workers share the cores with each other and run at idle
+ * priority, so wall clock time would mostly measure how long they were waiting to be scheduled.
+ */
+static double threadCpuMillis() {
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+CalibrationTuner::~CalibrationTuner() {
+    cancel();
+}
+
+bool CalibrationTuner::start(const std::string &clip_path, const std::string &labels_path) {
+    cancel();
+    if (!loadLabels(labels_path, labels)) {
+        return false;
+    }
+    this->clip_path = clip_path;
+    {
+        std::lock_guard<std::mutex> lock(result_mutex);
+        result = TunerResult();
+        has_result = false;
+    }
+    cancelled = false;
+    running = true;
+    coordinator = std::thread(&CalibrationTuner::run, this);
+    return true;
+}
+
+void CalibrationTuner::cancel() {
+    cancelled = true;
+    if (coordinator.joinable()) {
+        coordinator.join();
+    }
+    running = false;
+}
+
+bool CalibrationTuner::isRunning() const {
+    return running;
+}
+
+float CalibrationTuner::getProgress() const {
+    const size_t n = num_candidates;
+    return n == 0 ? 0.0f : static_cast<float>(num_evaluated) / n;
+}
+
+/**
+ * Returns the result once, after the search has finished.
+ */
+bool CalibrationTuner::takeResult(TunerResult &r) {
+    std::lock_guard<std::mutex> lock(result_mutex);
+    if (!has_result) {
+        return false;
+    }
+    r = result;
+    has_result = false;
+    return true;
+}
+
+/**
+ * Reads labels from a text file with one "frame x y" line per labelled frame, e.g. "120 0.45 0.61".
+ * Frames are numbered from 1, lines with frame 0 are skipped. Lines starting with # are comments.
+ */
+bool CalibrationTuner::loadLabels(const std::string &path, std::vector<TunerLabel> &labels) {
+    std::ifstream in(path);
+    if (!in) {
+        return false;
+    }
+    labels.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        std::istringstream fields(line);
+        TunerLabel label;
+        if (fields >> label.frame >> label.x >> label.y && label.frame > 0) {
+            labels.push_back(label);
+        }
+    }
+    return std::any_of(labels.begin(), labels.end(), [](const TunerLabel &l) { return l.x >= 0; });
+}
+
+//--------------------------------------------------------------
+
+void CalibrationTuner::run() {
+    candidates.clear();
+    num_candidates = 0;
+    num_evaluated = 0;
+    next_candidate = 0;
+
+    if (cacheFrames()) {
+        for (int radius : RADII) {
+            for (int th : TOL_H) {
+                for (int ts : TOL_S) {
+                    for (int tv : TOL_V) {
+                        MaskCandidate c;
+                        c.tol_h = th;
+                        c.tol_s = ts;
+                        c.tol_v = tv;
+                        sampleRange(radius, c);
+                        candidates.push_back(c);
+                    }
+                }
+            }
+        }
+        num_candidates = candidates.size();
+
+        const unsigned int n = std::max(1u, std::thread::hardware_concurrency());
+        std::vector<std::thread> workers;
+        for (unsigned int i = 0; i < n; i++) {
+            workers.emplace_back(&CalibrationTuner::worker, this);
+        }
+        for (std::thread &w : workers) {
+            w.join();
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(result_mutex);
+        result.num_candidates = num_evaluated * (sizeof(MIN_AREA) / sizeof(MIN_AREA[0])) *
+                                (sizeof(MAX_AREA_FRACTION) / sizeof(MAX_AREA_FRACTION[0]));
+        has_result = !cancelled;
+    }
+    frames.clear();
+    running = false;
+}
+
+void CalibrationTuner::worker() {
+    // Only use cores that are otherwise idle.
+#if defined(__linux__)
+    sched_param param;
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#endif
+
+    TunerResult best;
+    while (!cancelled) {
+        const size_t i = next_candidate++;
+        if (i >= candidates.size()) {
+            break;
+        }
+        evaluate(candidates[i], best);
+        num_evaluated++;
+    }
+
+    std::lock_guard<std::mutex> lock(result_mutex);
+    if (best.valid && best.score > result.score) {
+        result = best;
+    }
+}
+
+void CalibrationTuner::evaluate(const MaskCandidate &c, TunerResult &best) {
+    cv::Mat maskH, maskS, maskV, ftr;
+    std::vector<std::vector<cv::Point>> contours;
+
+    // Largest blob per frame, as the live tracker selects it.
+    std::vector<float> max_area(frames.size(), 0.0f);
+    std::vector<cv::Point2f> center(frames.size());
+
+    // Augment the tolerances to the sampled range, like the live tracker does.
+    const int Hmin_tol = std::max(0, c.Hmin - c.tol_h);
+    const int Hmax_tol = std::min(255, c.Hmax + c.tol_h);
+    const int Smin_tol = std::max(0, c.Smin - c.tol_s);
+    const int Smax_tol = std::min(255, c.Smax + c.tol_s);
+    const int Vmin_tol = std::max(0, c.Vmin - c.tol_v);
+    const int Vmax_tol = std::min(255, c.Vmax + c.tol_v);
+
+    const double t0 = threadCpuMillis();
+    for (size_t f = 0; f < frames.size(); f++) {
+        const CachedFrame &frame = frames[f];
+        ColorFilter::filter(frame.h, frame.s, frame.b, Hmin_tol, Hmax_tol, Smin_tol, Smax_tol, Vmin_tol, Vmax_tol,
+                            maskH, maskS, maskV, ftr);
+        cv::findContours(ftr, contours, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        for (const std::vector<cv::Point> &contour : contours) {
+            const cv::Moments mu = cv::moments(contour, false);
+            if (mu.m00 > max_area[f]) {
+                max_area[f] = static_cast<float>(mu.m00);
+                center[f] = cv::Point2f(static_cast<float>(mu.m10 / mu.m00 / ftr.cols),
+                                        static_cast<float>(mu.m01 / mu.m00 / ftr.rows));
+            }
+        }
+    }
+    const float cost_ms = static_cast<float>((threadCpuMillis() - t0) / frames.size());
+
+    // The area range only selects among the blobs found above, so all area candidates share the contours.
+    const size_t A = static_cast<size_t>(frames[0].h.cols) * frames[0].h.rows;
+    for (size_t min_area : MIN_AREA) {
+        for (float max_fraction : MAX_AREA_FRACTION) {
+            const size_t max_area_size = static_cast<size_t>(max_fraction * A);
+            int positives = 0;
+            int hits = 0;
+            int false_positives = 0;
+            for (size_t f = 0; f < frames.size(); f++) {
+                const TunerLabel &label = frames[f].label;
+                const bool detected = max_area[f] > min_area && max_area[f] < max_area_size;
+                if (label.x >= 0) {
+                    positives++;
+                }
+                if (!detected) {
+                    continue;
+                }
+                const float dx = center[f].x - label.x;
+                const float dy = center[f].y - label.y;
+                if (label.x >= 0 && dx * dx + dy * dy < MAX_LABEL_DISTANCE * MAX_LABEL_DISTANCE) {
+                    hits++;
+                } else {
+                    false_positives++;
+                }
+            }
+
+            const float detection_rate = static_cast<float>(hits) / std::max(1, positives);
+            const float false_positive_rate = static_cast<float>(false_positives) / frames.size();
+            const float score = detection_rate - false_positive_rate - COST_WEIGHT * cost_ms;
+            if (score > best.score) {
+                best.valid = true;
+                best.tol_h = c.tol_h;
+                best.tol_s = c.tol_s;
+                best.tol_v = c.tol_v;
+                best.sample_radius = c.sample_radius;
+                best.min_area_size = min_area;
+                best.max_area_size = max_area_size;
+                best.Hmin = c.Hmin;
+                best.Hmax = c.Hmax;
+                best.Smin = c.Smin;
+                best.Smax = c.Smax;
+                best.Vmin = c.Vmin;
+                best.Vmax = c.Vmax;
+                best.detection_rate = detection_rate;
+                best.false_positive_rate = false_positive_rate;
+                best.cost_ms = cost_ms;
+                best.score = score;
+            }
+        }
+    }
+}
+
+/**
+ * Converts the labelled frames to HSV once. All candidates share these read-only.
+ */
+bool CalibrationTuner::cacheFrames() {
+    frames.clear();
+    FrameFileSource clip;
+    if (!clip.open(clip_path) || clip.getChannels() != 3) {
+        return false;
+    }
+    cv::Mat rgb;
+    cv::Mat hsb;
+    for (const TunerLabel &label : labels) {
+        if (cancelled) {
+            return false;
+        }
+        if (!clip.seek(label.frame - 1)) {
+            continue;
+        }
+        const cv::Mat rgbm(clip.getHeight(), clip.getWidth(), CV_8UC3, const_cast<unsigned char *>(clip.getPixels()));
+
+        // Mirror camera image, like the live pipeline does
+        cv::flip(rgbm, rgb, 1);
+        CachedFrame frame;
+        frame.label = label;
+        ColorFilter::toHsv(rgb, hsb, frame.h, frame.s, frame.b);
+        frames.push_back(frame);
+    }
+    return std::any_of(frames.begin(), frames.end(), [](const CachedFrame &f) { return f.label.x >= 0; });
+}
+
+/**
+ * Samples the HSV range around all labelled positions, augmented with the candidate's tolerances.
+ */
+void CalibrationTuner::sampleRange(int radius, MaskCandidate &c) const {
+    int Hmin = 255, Hmax = 0, Smin = 255, Smax = 0, Vmin = 255, Vmax = 0;
+    for (const CachedFrame &frame : frames) {
+        if (frame.label.x < 0) {
+            continue;
+        }
+        const int cx = static_cast<int>(frame.label.x * frame.h.cols);
+        const int cy = static_cast<int>(frame.label.y * frame.h.rows);
+        for (int y = std::max(0, cy - radius); y <= std::min(frame.h.rows - 1, cy + radius); y++) {
+            for (int x = std::max(0, cx - radius); x <= std::min(frame.h.cols - 1, cx + radius); x++) {
+                const int h_i = frame.h.at<uchar>(y, x);
+                const int s_i = frame.s.at<uchar>(y, x);
+                const int v_i = frame.b.at<uchar>(y, x);
+                Hmin = std::min(Hmin, h_i);
+                Hmax = std::max(Hmax, h_i);
+                Smin = std::min(Smin, s_i);
+                Smax = std::max(Smax, s_i);
+                Vmin = std::min(Vmin, v_i);
+                Vmax = std::max(Vmax, v_i);
+            }
+        }
+    }
+    c.sample_radius = radius;
+    c.Hmin = Hmin;
+    c.Hmax = Hmax;
+    c.Smin = Smin;
+    c.Smax = Smax;
+    c.Vmin = Vmin;
+    c.Vmax = Vmax;
+}
@@ -0,0 +1,118 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+/**
+ * Labelled object position in a frame of a raw camera recording, normalized to [0, 1] in the mirrored
+ * image as shown on screen. A negative x means that the object is not in the frame. Frames are numbered
+ * from 1, like the frame number shown during replay and the sequence number in the recording.
+ */
+struct TunerLabel {
+    uint64_t frame = 0;
+    float x = -1.0f;
+    float y = -1.0f;
+};
+
+struct TunerResult {
+    bool valid = false;
+    int tol_h = 0;
+    int tol_s = 0;
+    int tol_v = 0;
+    int sample_radius = 0;
+    size_t min_area_size = 0;
+    size_t max_area_size = 0;
+    int Hmin = 0;
+    int Hmax = 0;
+    int Smin = 0;
+    int Smax = 0;
+    int Vmin = 0;
+    int Vmax = 0;
+    float detection_rate = 0.0f;
+    float false_positive_rate = 0.0f;
+    float cost_ms = 0.0f;
+    float score = -1e9f;
+    size_t num_candidates = 0;
+};
+
+/**
+ * Searches the calibration settings offline against a raw camera recording with labelled object positions.
+ *
+ * The calibrated colour range is sampled from the labelled positions, like a mouse click does live. Each
+ * candidate is scored on detection rate, false positive rate and per-frame cost. The colour conversion of
+ * the labelled frames is computed once and shared read-only by all candidates, and the contours of each
+ * colour mask are shared by all area range candidates. The search runs on all cores at idle priority, so
+ * it does not compete with live tracking.
+ */
+class CalibrationTuner {
+
+public:
+
+    ~CalibrationTuner();
+
+    bool start(const std::string &clip_path, const std::string &labels_path);
+
+    void cancel();
+
+    bool isRunning() const;
+
+    float getProgress() const;
+
+    bool takeResult(TunerResult &result);
+
+    static bool loadLabels(const std::string &path, std::vector<TunerLabel> &labels);
+
+private:
+
+    struct CachedFrame {
+        TunerLabel label;
+        cv::Mat h;
+        cv::Mat s;
+        cv::Mat b;
+    };
+
+    struct MaskCandidate {
+        int sample_radius;
+        int tol_h;
+        int tol_s;
+        int tol_v;
+        int Hmin, Hmax, Smin, Smax, Vmin, Vmax;
+    };
+
+    void run();
+
+    void worker();
+
+    void evaluate(const MaskCandidate &candidate, TunerResult &best);
+
+    bool cacheFrames();
+
+    void sampleRange(int radius, MaskCandidate &candidate) const;
+
+    std::string clip_path;
+    std::vector<TunerLabel> labels;
+    std::vector<CachedFrame> frames;
+    std::vector<MaskCandidate> candidates;
+
+    std::thread coordinator;
+    std::atomic<bool> running{false};
+    std::atomic<bool> cancelled{false};
+    std::atomic<size_t> num_candidates{0};
+    std::atomic<size_t> next_candidate{0};
+    std::atomic<size_t> num_evaluated{0};
+
+    std::mutex result_mutex;
+    TunerResult result;
+    bool has_result = false;
+
+};
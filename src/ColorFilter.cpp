@@ -0,0 +1,38 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "ColorFilter.h"
+
+#include <opencv2/imgproc.hpp>
+
+void ColorFilter::toHsv(const cv::Mat &rgb, cv::Mat &hsb, cv::Mat &h, cv::Mat &s, cv::Mat &b) {
+    cv::cvtColor(rgb, hsb, cv::COLOR_RGB2HSV_FULL);
+
+    // Add a bit of blur to eliminate camera noise.
+    cv::blur(hsb, hsb, cv::Size(10, 10));
+
+    // Split the hsv image per channel into grayscale images, reusing their buffers
+    cv::extractChannel(hsb, h, 0);
+    cv::extractChannel(hsb, s, 1);
+    cv::extractChannel(hsb, b, 2);
+}
+
+void ColorFilter::filter(const cv::Mat &h, const cv::Mat &s, const cv::Mat &b,
+                         int Hmin, int Hmax, int Smin, int Smax, int Vmin, int Vmax,
+                         cv::Mat &maskH, cv::Mat &maskS, cv::Mat &maskV, cv::Mat &ftr) {
+    cv::inRange(h, Hmin, Hmax, maskH);
+    cv::inRange(s, Smin, Smax, maskS);
+    cv::inRange(b, Vmin, Vmax, maskV);
+
+    // Add all 3 masks with binary AND operation, in place to avoid temporaries
+    cv::bitwise_and(maskH, maskS, ftr);
+    cv::bitwise_and(ftr, maskV, ftr);
+
+    // Fill holes
+    static const cv::Mat st_elem = cv::getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
+    cv::erode(ftr, ftr, st_elem);
+    cv::dilate(ftr, ftr, st_elem);
+    cv::dilate(ftr, ftr, st_elem);
+    cv::erode(ftr, ftr, st_elem);
+}
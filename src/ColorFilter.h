@@ -0,0 +1,28 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <opencv2/core.hpp>
+
+/**
+ * The colour filter of the tracking pipeline, shared by the live tracker and the calibration tuner.
+ */
+class ColorFilter {
+
+public:
+
+    /**
+     * Converts a mirrored RGB frame to blurred HSV and splits it per channel into h, s and b.
+     */
+    static void toHsv(const cv::Mat &rgb, cv::Mat &hsb, cv::Mat &h, cv::Mat &s, cv::Mat &b);
+
+    /**
+     * Computes the binary mask of the pixels within the (tolerance augmented) HSV range and fills its holes.
+     */
+    static void filter(const cv::Mat &h, const cv::Mat &s, const cv::Mat &b,
+                       int Hmin, int Hmax, int Smin, int Smax, int Vmin, int Vmax,
+                       cv::Mat &maskH, cv::Mat &maskS, cv::Mat &maskV, cv::Mat &ftr);
+
+};
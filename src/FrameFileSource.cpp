@@ -0,0 +1,126 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "FrameFileSource.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+FrameFileSource::~FrameFileSource() {
+    close();
+}
+
+bool FrameFileSource::open(const std::string &path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<uint64_t>(st.st_size) < FRAME_FILE_PAGE_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    mapping_size = static_cast<size_t>(st.st_size);
+    mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        return false;
+    }
+
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, FRAME_FILE_MAGIC, sizeof(header.magic)) != 0 ||
+            header.version != FRAME_FILE_VERSION ||
+            header.slot_size < sizeof(FrameSlotHeader) +
+                    static_cast<uint64_t>(header.width) * header.height * header.channels) {
+        close();
+        return false;
+    }
+
+    // Replay is sequential, let the OS read ahead.
+    madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+
+    num_frames = (mapping_size - FRAME_FILE_PAGE_SIZE) / header.slot_size;
+    current = 0;
+    has_frame = false;
+    return true;
+}
+
+void FrameFileSource::close() {
+    if (mapping != nullptr) {
+        munmap(mapping, mapping_size);
+    }
+    mapping = nullptr;
+    mapping_size = 0;
+    num_frames = 0;
+    current = 0;
+    has_frame = false;
+}
+
+bool FrameFileSource::isOpen() const {
+    return mapping != nullptr;
+}
+
+/**
+ * Advances to the next recorded frame. Returns false at the end of the recording.
+ */
+bool FrameFileSource::update() {
+    if (!isOpen()) {
+        return false;
+    }
+    return seek(has_frame ? current + 1 : 0);
+}
+
+bool FrameFileSource::seek(uint64_t frame) {
+    // A zero sequence number marks the unused tail of a recording that was not closed cleanly.
+    if (frame >= num_frames || slot(frame)->sequence == 0) {
+        return false;
+    }
+    current = frame;
+    has_frame = true;
+    return true;
+}
+
+const unsigned char *FrameFileSource::getPixels() const {
+    if (!has_frame) {
+        return nullptr;
+    }
+    return reinterpret_cast<const unsigned char *>(slot(current)) + sizeof(FrameSlotHeader);
+}
+
+uint64_t FrameFileSource::getTimestampMicros() const {
+    return has_frame ? slot(current)->timestamp_us : 0;
+}
+
+uint64_t FrameFileSource::getFrameIndex() const {
+    return current;
+}
+
+uint64_t FrameFileSource::getNumFrames() const {
+    return num_frames;
+}
+
+int FrameFileSource::getWidth() const {
+    return static_cast<int>(header.width);
+}
+
+int FrameFileSource::getHeight() const {
+    return static_cast<int>(header.height);
+}
+
+int FrameFileSource::getChannels() const {
+    return static_cast<int>(header.channels);
+}
+
+//--------------------------------------------------------------
+
+const FrameSlotHeader *FrameFileSource::slot(uint64_t frame) const {
+    return reinterpret_cast<const FrameSlotHeader *>(
+            static_cast<const unsigned char *>(mapping) + FRAME_FILE_PAGE_SIZE + frame * header.slot_size);
+}
@@ -0,0 +1,61 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "FrameRecord.h"
+
+/**
+ * Reads a raw camera recording (*.octraw) as a frame source, in place of the video grabber.
+ *
+ * The file is memory-mapped read-only and frames are handed out without copying. Every call to update()
+ * advances exactly one frame, so a replay feeds the pipeline the same frames in the same order as the
+ * recorded session, independent of the frame rate of the app.
+ */
+class FrameFileSource {
+
+public:
+
+    ~FrameFileSource();
+
+    bool open(const std::string &path);
+
+    void close();
+
+    bool isOpen() const;
+
+    bool update();
+
+    bool seek(uint64_t frame);
+
+    const unsigned char *getPixels() const;
+
+    uint64_t getTimestampMicros() const;
+
+    uint64_t getFrameIndex() const;
+
+    uint64_t getNumFrames() const;
+
+    int getWidth() const;
+
+    int getHeight() const;
+
+    int getChannels() const;
+
+private:
+
+    const FrameSlotHeader *slot(uint64_t frame) const;
+
+    void *mapping = nullptr;
+    size_t mapping_size = 0;
+    FrameFileHeader header;
+    uint64_t num_frames = 0;
+    uint64_t current = 0;
+    bool has_frame = false;
+
+};
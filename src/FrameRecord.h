@@ -0,0 +1,40 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * On-disk layout of a raw camera recording (*.octraw).
+ *
+ * The file starts with a page-sized FrameFileHeader, followed by fixed-size frame slots. Each slot holds a
+ * FrameSlotHeader and the raw, unmirrored RGB pixels as delivered by the camera. Slots are padded to a
+ * multiple of the page size, so every slot can be mapped on its own. A slot with a zero sequence number
+ * marks the preallocated but unused tail of the file.
+ */
+
+static const char FRAME_FILE_MAGIC[8] = {'O', 'C', 'T', 'R', 'A', 'W', '0', '1'};
+static const uint32_t FRAME_FILE_VERSION = 1;
+static const uint64_t FRAME_FILE_PAGE_SIZE = 4096;
+
+struct FrameFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t channels;
+    uint64_t slot_size;         // bytes per frame slot, including the FrameSlotHeader
+    uint64_t start_time_us;     // wall clock time of the first frame, in microseconds since epoch
+    uint8_t reserved[24];
+};
+
+struct FrameSlotHeader {
+    uint64_t sequence;          // 1-based frame number, 0 for an unused slot
+    uint64_t timestamp_us;      // capture time since start of the recording, in microseconds
+    uint8_t reserved[48];
+};
+
+static_assert(sizeof(FrameFileHeader) == 64, "FrameFileHeader must be 64 bytes");
+static_assert(sizeof(FrameSlotHeader) == 64, "FrameSlotHeader must be 64 bytes");
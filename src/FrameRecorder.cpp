@@ -0,0 +1,224 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "FrameRecorder.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+FrameRecorder::FrameRecorder() = default;
+
+FrameRecorder::~FrameRecorder() {
+    close();
+}
+
+bool FrameRecorder::open(const std::string &path, int width, int height, int channels) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    this->path = path;
+    error.clear();
+    frame_size = static_cast<size_t>(width) * height * channels;
+    slot_size = (sizeof(FrameSlotHeader) + frame_size + FRAME_FILE_PAGE_SIZE - 1) / FRAME_FILE_PAGE_SIZE * FRAME_FILE_PAGE_SIZE;
+    num_frames = 0;
+    num_dropped = 0;
+    allocated_chunks = 0;
+
+    FrameFileHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, FRAME_FILE_MAGIC, sizeof(header.magic));
+    header.version = FRAME_FILE_VERSION;
+    header.width = static_cast<uint32_t>(width);
+    header.height = static_cast<uint32_t>(height);
+    header.channels = static_cast<uint32_t>(channels);
+    header.slot_size = slot_size;
+    header.start_time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+
+    // Preallocate the first chunk only, the writer thread allocates the next one and stays one chunk ahead.
+    if (pwrite(fd, &header, sizeof(header), 0) != sizeof(header) || !preallocate(0) || !mapChunk(0)) {
+        error = "Cannot allocate " + path + ": " + std::strerror(errno);
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    // Touch the back buffers now, so the first frames do not page fault.
+    for (BackBuffer &b : buffers) {
+        b.pixels.assign(frame_size, 0);
+        b.full = false;
+    }
+    push_index = 0;
+
+    start = std::chrono::steady_clock::now();
+    running = true;
+    writer = std::thread(&FrameRecorder::writerFunction, this);
+    return true;
+}
+
+/**
+ * Closes the recording. Returns false, with the reason in getError(), if the preallocated tail could not be
+ * released. The reader stops at the first unused slot, so the recording is still valid in that case.
+ */
+bool FrameRecorder::close() {
+    if (writer.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        cv.notify_one();
+        writer.join();
+    }
+    if (chunk_data != nullptr) {
+        munmap(chunk_data, CHUNK_FRAMES * slot_size);
+        chunk_data = nullptr;
+    }
+    bool ok = true;
+    if (fd >= 0) {
+        // Release the preallocated tail.
+        if (ftruncate(fd, static_cast<off_t>(FRAME_FILE_PAGE_SIZE + num_frames * slot_size)) != 0) {
+            error = "Cannot truncate " + path + ": " + std::strerror(errno);
+            ok = false;
+        }
+        ::close(fd);
+        fd = -1;
+    }
+    return ok;
+}
+
+bool FrameRecorder::isOpen() const {
+    return fd >= 0;
+}
+
+const std::string &FrameRecorder::getPath() const {
+    return path;
+}
+
+const std::string &FrameRecorder::getError() const {
+    return error;
+}
+
+void FrameRecorder::push(const unsigned char *pixels, size_t size, std::chrono::steady_clock::time_point capture_time) {
+    if (!running) {
+        return;
+    }
+    if (size != frame_size) {
+        // The camera changed resolution or format, this frame does not fit the recording.
+        num_dropped++;
+        return;
+    }
+    BackBuffer &b = buffers[push_index];
+    if (b.full.load(std::memory_order_acquire)) {
+        // The writer still owns this buffer, the disk cannot keep up.
+        num_dropped++;
+        return;
+    }
+    std::memcpy(b.pixels.data(), pixels, frame_size);
+    b.timestamp_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            capture_time - start).count());
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        b.full.store(true, std::memory_order_release);
+    }
+    cv.notify_one();
+    push_index ^= 1;
+}
+
+uint64_t FrameRecorder::getNumFrames() const {
+    return num_frames;
+}
+
+uint64_t FrameRecorder::getNumDroppedFrames() const {
+    return num_dropped;
+}
+
+//--------------------------------------------------------------
+
+void FrameRecorder::writerFunction() {
+    // If this fails, the switch to the next chunk tries again.
+    preallocate(1);
+
+    int write_index = 0;
+    while (true) {
+        BackBuffer &b = buffers[write_index];
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return b.full.load(std::memory_order_acquire) || !running; });
+            // Drain the pending frames before stopping.
+            if (!b.full.load(std::memory_order_acquire)) {
+                break;
+            }
+        }
+
+        const uint64_t index = num_frames;
+        const uint64_t chunk = index / CHUNK_FRAMES;
+        if (chunk_data == nullptr || chunk != mapped_chunk) {
+            if (!preallocate(chunk + 1) || !mapChunk(chunk)) {
+                b.full.store(false, std::memory_order_release);
+                num_dropped++;
+                write_index ^= 1;
+                continue;
+            }
+        }
+
+        unsigned char *slot = chunk_data + (index % CHUNK_FRAMES) * slot_size;
+        FrameSlotHeader header;
+        std::memset(&header, 0, sizeof(header));
+        header.sequence = index + 1;
+        header.timestamp_us = b.timestamp_us;
+        std::memcpy(slot + sizeof(FrameSlotHeader), b.pixels.data(), frame_size);
+        std::memcpy(slot, &header, sizeof(header));
+
+        b.full.store(false, std::memory_order_release);
+        num_frames++;
+        write_index ^= 1;
+    }
+}
+
+bool FrameRecorder::mapChunk(uint64_t chunk) {
+    const size_t chunk_size = CHUNK_FRAMES * slot_size;
+    if (chunk_data != nullptr) {
+        // Let the OS write back the finished chunk in the background.
+        msync(chunk_data, chunk_size, MS_ASYNC);
+        munmap(chunk_data, chunk_size);
+        chunk_data = nullptr;
+    }
+    const off_t offset = static_cast<off_t>(FRAME_FILE_PAGE_SIZE + chunk * chunk_size);
+    void *p = mmap(nullptr, chunk_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, offset);
+    if (p == MAP_FAILED) {
+        return false;
+    }
+    chunk_data = static_cast<unsigned char *>(p);
+    mapped_chunk = chunk;
+    return true;
+}
+
+bool FrameRecorder::preallocate(uint64_t chunk) {
+    if (chunk < allocated_chunks) {
+        return true;
+    }
+    const off_t size = static_cast<off_t>(FRAME_FILE_PAGE_SIZE + (chunk + 1) * CHUNK_FRAMES * slot_size);
+#ifdef __linux__
+    // Reserve the disk blocks now, so writing the frames later does not have to allocate them.
+    const int result = posix_fallocate(fd, 0, size);
+    if (result != 0) {
+        // posix_fallocate returns the error instead of setting errno.
+        errno = result;
+        return false;
+    }
+#else
+    if (ftruncate(fd, size) != 0) {
+        return false;
+    }
+#endif
+    allocated_chunks = chunk + 1;
+    return true;
+}
@@ -0,0 +1,89 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameRecord.h"
+
+/**
+ * Streams raw camera frames to a preallocated, memory-mapped file (*.octraw).
+ *
+ * push() only copies the frame into one of two back buffers and wakes the writer thread, which moves the
+ * frame into the file and preallocates the next chunk of the file well before it is needed. The tracking
+ * thread never waits for the disk. A frame is dropped, and counted, only when both back buffers are still
+ * waiting for the writer, i.e. when the disk cannot keep up with the camera, or when the frame does not have
+ * the size the recording was opened with.
+ */
+class FrameRecorder {
+
+public:
+
+    FrameRecorder();
+
+    ~FrameRecorder();
+
+    bool open(const std::string &path, int width, int height, int channels);
+
+    bool close();
+
+    bool isOpen() const;
+
+    const std::string &getPath() const;
+
+    const std::string &getError() const;
+
+    void push(const unsigned char *pixels, size_t size, std::chrono::steady_clock::time_point capture_time);
+
+    uint64_t getNumFrames() const;
+
+    uint64_t getNumDroppedFrames() const;
+
+private:
+
+    // Frames per preallocated chunk, about 4 seconds at 60fps.
+    static const uint64_t CHUNK_FRAMES = 256;
+
+    struct BackBuffer {
+        std::vector<unsigned char> pixels;
+        uint64_t timestamp_us = 0;
+        std::atomic<bool> full{false};
+    };
+
+    void writerFunction();
+
+    bool mapChunk(uint64_t chunk);
+
+    bool preallocate(uint64_t chunk);
+
+    std::string path;
+    std::string error;
+    int fd = -1;
+    size_t frame_size = 0;
+    uint64_t slot_size = 0;
+    std::chrono::steady_clock::time_point start;
+
+    BackBuffer buffers[2];
+    int push_index = 0;
+
+    std::thread writer;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::atomic<bool> running{false};
+
+    unsigned char *chunk_data = nullptr;
+    uint64_t mapped_chunk = 0;
+    uint64_t allocated_chunks = 0;
+
+    std::atomic<uint64_t> num_frames{0};
+    std::atomic<uint64_t> num_dropped{0};
+
+};
@@ -0,0 +1,158 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "LatencyTracer.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+static const char *STAGE_NAMES[TRACE_NUM_STAGES] = {
+        "capture", "filter", "contours", "blobs", "location", "send"
+};
+
+LatencyTracer::LatencyTracer(size_t capacity)
+        : start(std::chrono::steady_clock::now()), traces(capacity), loopback(capacity, 0) {
+}
+
+/**
+ * Starts the trace of a new frame. Stages that are not reached, e.g. when the frame is dropped, stay at -1.
+ */
+void LatencyTracer::begin(std::chrono::steady_clock::time_point capture_time) {
+    const int64_t capture_us = std::chrono::duration_cast<std::chrono::microseconds>(capture_time - start).count();
+    trace.frame = ++frame;
+    trace.capture_wall_us = wallClockMicros() - (now() - capture_us);
+    std::fill(std::begin(trace.stage_us), std::end(trace.stage_us), -1);
+    trace.stage_us[TRACE_CAPTURE] = capture_us;
+    trace.sent = false;
+}
+
+void LatencyTracer::mark(TraceStage stage) {
+    trace.stage_us[stage] = now();
+}
+
+void LatencyTracer::markSent() {
+    mark(TRACE_SEND);
+    trace.sent = true;
+}
+
+void LatencyTracer::end() {
+    if (traces.empty()) {
+        return;
+    }
+    traces[next] = trace;
+    next = (next + 1) % traces.size();
+    count = std::min(count + 1, traces.size());
+}
+
+const FrameTrace &LatencyTracer::current() const {
+    return trace;
+}
+
+void LatencyTracer::addLoopbackLatency(int64_t latency_us) {
+    if (loopback.empty()) {
+        return;
+    }
+    loopback[loopback_next] = latency_us;
+    loopback_next = (loopback_next + 1) % loopback.size();
+    loopback_count = std::min(loopback_count + 1, loopback.size());
+}
+
+void LatencyTracer::clear() {
+    next = 0;
+    count = 0;
+    loopback_next = 0;
+    loopback_count = 0;
+}
+
+//--------------------------------------------------------------
+
+static void appendDistribution(std::ostringstream &out, const std::string &name, std::vector<int64_t> &v) {
+    out << "  " << name;
+    for (size_t i = name.size(); i < 22; i++) {
+        out << ' ';
+    }
+    if (v.empty()) {
+        out << "no samples\n";
+        return;
+    }
+    std::sort(v.begin(), v.end());
+    const auto pct = [&](double p) {
+        return v[std::min(v.size() - 1, static_cast<size_t>(p * v.size()))] / 1000.0;
+    };
+    out.setf(std::ios::fixed);
+    out.precision(2);
+    out << "p50 " << pct(0.50) << " ms, p95 " << pct(0.95) << " ms, p99 " << pct(0.99)
+        << " ms, max " << v.back() / 1000.0 << " ms (" << v.size() << " frames)\n";
+}
+
+/**
+ * Returns the latency distribution per stage, of capture-to-send and of the loopback round trip.
+ */
+std::string LatencyTracer::report() const {
+    std::vector<int64_t> stages[TRACE_NUM_STAGES];
+    std::vector<int64_t> total;
+    for (size_t i = 0; i < count; i++) {
+        const FrameTrace &t = traces[i];
+        int64_t previous = t.stage_us[TRACE_CAPTURE];
+        for (int s = TRACE_FILTER; s < TRACE_NUM_STAGES; s++) {
+            if (t.stage_us[s] >= 0) {
+                stages[s].push_back(t.stage_us[s] - previous);
+                previous = t.stage_us[s];
+            }
+        }
+        if (t.sent) {
+            total.push_back(t.stage_us[TRACE_SEND] - t.stage_us[TRACE_CAPTURE]);
+        }
+    }
+    std::vector<int64_t> round_trip(loopback.begin(), loopback.begin() + loopback_count);
+
+    std::ostringstream out;
+    out << "Latency report\n";
+    for (int s = TRACE_FILTER; s < TRACE_NUM_STAGES; s++) {
+        appendDistribution(out, STAGE_NAMES[s], stages[s]);
+    }
+    appendDistribution(out, "capture to send", total);
+    appendDistribution(out, "capture to loopback", round_trip);
+    return out.str();
+}
+
+/**
+ * Writes the collected traces in the Chrome trace event format, for chrome://tracing or Perfetto.
+ */
+bool LatencyTracer::writeChromeTrace(const std::string &path) const {
+    std::ofstream out(path);
+    if (!out) {
+        return false;
+    }
+    out << "{\"traceEvents\":[\n";
+    bool first = true;
+    const size_t oldest = count < traces.size() ? 0 : next;
+    for (size_t i = 0; i < count; i++) {
+        const FrameTrace &t = traces[(oldest + i) % traces.size()];
+        int64_t previous = t.stage_us[TRACE_CAPTURE];
+        for (int s = TRACE_FILTER; s < TRACE_NUM_STAGES; s++) {
+            if (t.stage_us[s] < 0) {
+                continue;
+            }
+            out << (first ? "" : ",\n")
+                << "{\"name\":\"" << STAGE_NAMES[s] << "\",\"cat\":\"pipeline\",\"ph\":\"X\",\"pid\":1,\"tid\":1"
+                << ",\"ts\":" << previous << ",\"dur\":" << t.stage_us[s] - previous
+                << ",\"args\":{\"frame\":" << t.frame << "}}";
+            previous = t.stage_us[s];
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+int64_t LatencyTracer::wallClockMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+int64_t LatencyTracer::now() const {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+}
@@ -0,0 +1,83 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Pipeline stages of a frame, in order. Each stage is marked when it finishes.
+ */
+enum TraceStage {
+    TRACE_CAPTURE = 0,
+    TRACE_FILTER,
+    TRACE_CONTOURS,
+    TRACE_BLOBS,
+    TRACE_LOCATION,
+    TRACE_SEND,
+    TRACE_NUM_STAGES
+};
+
+/**
+ * Trace context of a single frame, from the capture timestamp to the moment the OSC message is sent.
+ */
+struct FrameTrace {
+    uint64_t frame = 0;
+    int64_t capture_wall_us = 0;        // capture time in microseconds since epoch, as sent over OSC
+    int64_t stage_us[TRACE_NUM_STAGES]; // steady clock, relative to the start of the tracer
+    bool sent = false;
+};
+
+/**
+ * Collects glass-to-OSC latency traces in a fixed-size ring, so tracing does not allocate per frame.
+ *
+ * The capture timestamp is the moment the app first sees a new frame from the grabber, which is the
+ * earliest point in time that is available on all platforms. Latencies measured by the loopback receiver
+ * are collected separately and include the OSC transport.
+ */
+class LatencyTracer {
+
+public:
+
+    explicit LatencyTracer(size_t capacity = 4096);
+
+    void begin(std::chrono::steady_clock::time_point capture_time);
+
+    void mark(TraceStage stage);
+
+    void markSent();
+
+    void end();
+
+    const FrameTrace &current() const;
+
+    void addLoopbackLatency(int64_t latency_us);
+
+    void clear();
+
+    std::string report() const;
+
+    bool writeChromeTrace(const std::string &path) const;
+
+    static int64_t wallClockMicros();
+
+private:
+
+    int64_t now() const;
+
+    std::chrono::steady_clock::time_point start;
+    std::vector<FrameTrace> traces;
+    size_t next = 0;
+    size_t count = 0;
+    FrameTrace trace;
+    uint64_t frame = 0;
+
+    std::vector<int64_t> loopback;
+    size_t loopback_next = 0;
+    size_t loopback_count = 0;
+
+};
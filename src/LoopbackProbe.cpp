@@ -0,0 +1,84 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "LoopbackProbe.h"
+
+#include "LatencyTracer.h"
+
+LoopbackProbe::~LoopbackProbe() {
+    stop();
+}
+
+bool LoopbackProbe::start(int port) {
+    stop();
+    try {
+        socket.reset(new UdpSocket());
+        socket->Bind(IpEndpointName(IpEndpointName::ANY_ADDRESS, port));
+    } catch (std::exception &e) {
+        socket.reset();
+        ofLogError("LoopbackProbe") << "Cannot listen on port " << port << ": " << e.what();
+        return false;
+    }
+    multiplexer.AttachSocketListener(socket.get(), this);
+    // Lets the receiving thread notice stopThread(), also when the break below comes before Run().
+    multiplexer.AttachPeriodicTimerListener(100, this);
+    startThread();
+    return true;
+}
+
+void LoopbackProbe::stop() {
+    if (isThreadRunning()) {
+        stopThread();
+        multiplexer.AsynchronousBreak();
+    }
+    waitForThread(false);
+    if (socket) {
+        multiplexer.DetachPeriodicTimerListener(this);
+        multiplexer.DetachSocketListener(socket.get(), this);
+        socket.reset();
+    }
+}
+
+std::vector<int64_t> LoopbackProbe::takeLatencies() {
+    std::vector<int64_t> v;
+    lock();
+    v.swap(latencies);
+    unlock();
+    return v;
+}
+
+//--------------------------------------------------------------
+
+void LoopbackProbe::threadedFunction() {
+    multiplexer.Run();
+}
+
+/**
+ * Called by the socket as soon as a packet is received, before it is parsed.
+ */
+void LoopbackProbe::ProcessPacket(const char *data, int size, const IpEndpointName &remoteEndpoint) {
+    receive_time = LatencyTracer::wallClockMicros();
+    osc::OscPacketListener::ProcessPacket(data, size, remoteEndpoint);
+}
+
+void LoopbackProbe::ProcessMessage(const osc::ReceivedMessage &m, const IpEndpointName &remoteEndpoint) {
+    if (m.ArgumentCount() == 0) {
+        return;
+    }
+    osc::ReceivedMessageArgumentIterator last = m.ArgumentsBegin();
+    for (osc::ReceivedMessageArgumentIterator arg = m.ArgumentsBegin(); arg != m.ArgumentsEnd(); ++arg) {
+        last = arg;
+    }
+    if (last->IsInt64()) {
+        lock();
+        latencies.push_back(receive_time - last->AsInt64Unchecked());
+        unlock();
+    }
+}
+
+void LoopbackProbe::TimerExpired() {
+    if (!isThreadRunning()) {
+        multiplexer.Break();
+    }
+}
@@ -0,0 +1,46 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+/**
+ * Receives the app's own OSC messages on a local port and measures capture-to-receive latency.
+ *
+ * The last argument of every message must be the capture timestamp (int64, microseconds since epoch).
+ * The thread blocks in the receiving socket and stamps every packet as soon as the socket delivers it,
+ * so the measurement does not include any polling delay.
+ */
+class LoopbackProbe : public ofThread, public osc::OscPacketListener, public TimerListener {
+
+public:
+
+    ~LoopbackProbe();
+
+    bool start(int port);
+
+    void stop();
+
+    std::vector<int64_t> takeLatencies();
+
+    void ProcessPacket(const char *data, int size, const IpEndpointName &remoteEndpoint) override;
+
+    void TimerExpired() override;
+
+protected:
+
+    void threadedFunction() override;
+
+    void ProcessMessage(const osc::ReceivedMessage &m, const IpEndpointName &remoteEndpoint) override;
+
+private:
+
+    std::unique_ptr<UdpSocket> socket;
+    SocketReceiveMultiplexer multiplexer;
+    int64_t receive_time = 0;
+    std::vector<int64_t> latencies;
+
+};
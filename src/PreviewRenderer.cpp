@@ -0,0 +1,178 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "PreviewRenderer.h"
+
+/**
+ * Returns true if a new snapshot should be taken for the given preview rate. A rate of 0 disables the preview.
+ */
+bool PreviewRenderer::isDue(int preview_fps) {
+    if (preview_fps <= 0) {
+        enabled = false;
+        last_update_us = 0;
+        return false;
+    }
+    enabled = true;
+    const uint64_t now = ofGetElapsedTimeMicros();
+    if (last_update_us != 0 && now - last_update_us < 1000000 / static_cast<uint64_t>(preview_fps)) {
+        return false;
+    }
+    last_update_us = now;
+    return true;
+}
+
+/**
+ * Copies the visible layers into the snapshot. Hidden layers are emptied, so a stale layer is never shown
+ * when it is switched on again before the next snapshot. Skips the snapshot if the render thread holds it.
+ */
+void PreviewRenderer::update(const cv::Mat &rgb, const std::vector<std::vector<cv::Point>> &contours,
+                             const std::vector<ofVec3f> &trail, int trail_position,
+                             bool show_webcam_view, bool show_contours, bool show_trail) {
+    std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+    if (!lock.owns_lock()) {
+        return;
+    }
+    snapshot.show_webcam_view = show_webcam_view && rgb.isContinuous();
+    if (snapshot.show_webcam_view) {
+        rgb.copyTo(snapshot.rgb);
+    }
+    snapshot.show_contours = show_contours;
+    if (show_contours) {
+        snapshot.contours = contours;
+    }
+    snapshot.show_trail = show_trail;
+    if (show_trail) {
+        snapshot.trail = trail;
+        snapshot.trail_position = trail_position;
+    }
+    has_snapshot = true;
+}
+
+/**
+ * Moves the latest snapshot to the texture and the meshes. Call from the render thread.
+ */
+void PreviewRenderer::upload() {
+    if (!enabled) {
+        if (has_frame) {
+            clear();
+        }
+        return;
+    }
+    {
+        // Swap the buffers, the tracking thread copies the next snapshot into the previous ones.
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!has_snapshot) {
+            return;
+        }
+        std::swap(snapshot, uploaded);
+        has_snapshot = false;
+    }
+
+    // Upload the frame once, it is drawn from the texture until the next snapshot.
+    has_texture = false;
+    if (uploaded.show_webcam_view) {
+        const cv::Mat &rgb = uploaded.rgb;
+        if (!texture.isAllocated() || texture.getWidth() != rgb.cols || texture.getHeight() != rgb.rows) {
+            texture.allocate(rgb.cols, rgb.rows, GL_RGB);
+        }
+        texture.loadData(rgb.ptr(), rgb.cols, rgb.rows, GL_RGB);
+        has_texture = true;
+    }
+
+    if (uploaded.show_contours) {
+        updateContourMesh(uploaded.contours);
+    } else {
+        contour_mesh.clear();
+    }
+    if (uploaded.show_trail) {
+        updateTrailMesh(uploaded.trail, uploaded.trail_position);
+    } else {
+        trail_mesh.clear();
+    }
+    has_frame = true;
+}
+
+void PreviewRenderer::clear() {
+    texture.clear();
+    contour_mesh.clear();
+    trail_mesh.clear();
+    has_frame = false;
+    has_texture = false;
+}
+
+void PreviewRenderer::drawPreview(bool show_webcam_view, bool show_contours) {
+    if (!has_frame) {
+        return;
+    }
+    if (show_webcam_view && has_texture) {
+        texture.draw(0, 0);
+    }
+    if (show_contours) {
+        ofPushStyle();
+        ofSetColor(255, 255, 255);
+        contour_mesh.draw();
+        ofPopStyle();
+    }
+}
+
+void PreviewRenderer::drawTrail() {
+    if (!has_frame) {
+        return;
+    }
+    ofPushStyle();
+    ofEnableAlphaBlending();
+    trail_mesh.draw();
+    ofPopStyle();
+}
+
+//--------------------------------------------------------------
+
+void PreviewRenderer::updateContourMesh(const std::vector<std::vector<cv::Point>> &contours) {
+    contour_mesh.clear();
+    contour_mesh.setMode(OF_PRIMITIVE_LINES);
+    for (const std::vector<cv::Point> &contour : contours) {
+        for (size_t i = 0; i < contour.size(); i++) {
+            const cv::Point &p = contour[i];
+            const cv::Point &q = contour[(i + 1) % contour.size()];
+            contour_mesh.addVertex(ofVec3f(p.x, p.y));
+            contour_mesh.addVertex(ofVec3f(q.x, q.y));
+        }
+    }
+}
+
+void PreviewRenderer::updateTrailMesh(const std::vector<ofVec3f> &trail, int trail_position) {
+    trail_mesh.clear();
+    trail_mesh.setMode(OF_PRIMITIVE_TRIANGLES);
+
+    const int n = static_cast<int>(trail.size());
+    const float w = ofGetWindowWidth();
+    const float h = ofGetWindowHeight();
+
+    ofVec3f circle[CIRCLE_RESOLUTION + 1];
+    for (int k = 0; k <= CIRCLE_RESOLUTION; k++) {
+        const float a = TWO_PI * k / CIRCLE_RESOLUTION;
+        circle[k] = ofVec3f(cos(a), sin(a));
+    }
+
+    for (int j = 0; j < n; j++) {
+
+        // Walk back from the latest position, older positions get smaller and more transparent.
+        const ofVec3f &v = trail[(trail_position - j + n) % n];
+        if (v.x == -1.0) {
+            continue;
+        }
+        const ofVec3f c(v.x * w, v.y * h);
+        const float radius = sqrt(v.z * w * h) * (n - j) / n;
+        const ofFloatColor color(1.0f, 1.0f, 1.0f, 32.0f / 255.0f * (n - j) / n);
+
+        for (int k = 0; k < CIRCLE_RESOLUTION; k++) {
+            trail_mesh.addVertex(c);
+            trail_mesh.addVertex(c + circle[k] * radius);
+            trail_mesh.addVertex(c + circle[k + 1] * radius);
+            trail_mesh.addColor(color);
+            trail_mesh.addColor(color);
+            trail_mesh.addColor(color);
+        }
+    }
+}
@@ -0,0 +1,76 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+
+#include "ofMain.h"
+#include "ofxCv.h"
+
+/**
+ * Draws the camera preview, the contours and the object trail, decoupled from the tracking.
+ *
+ * The tracking thread calls update() at the preview rate, which copies the visible layers into a snapshot and
+ * returns immediately if the render thread is busy with the previous one. On the render thread, upload()
+ * moves a new snapshot to a texture and batches the contours and the trail into a single mesh each. draw()
+ * only replays the retained texture and meshes, so rendering costs a few draw calls per frame, independent of
+ * the number of contours and trail points, and never touches the frame buffers of the vision stage. Layers
+ * that are hidden are neither copied nor uploaded.
+ */
+class PreviewRenderer {
+
+public:
+
+    bool isDue(int preview_fps);
+
+    void update(const cv::Mat &rgb, const std::vector<std::vector<cv::Point>> &contours,
+                const std::vector<ofVec3f> &trail, int trail_position,
+                bool show_webcam_view, bool show_contours, bool show_trail);
+
+    void upload();
+
+    void clear();
+
+    void drawPreview(bool show_webcam_view, bool show_contours);
+
+    void drawTrail();
+
+private:
+
+    struct Snapshot {
+        cv::Mat rgb;
+        std::vector<std::vector<cv::Point>> contours;
+        std::vector<ofVec3f> trail;
+        int trail_position = 0;
+        bool show_webcam_view = false;
+        bool show_contours = false;
+        bool show_trail = false;
+    };
+
+    void updateContourMesh(const std::vector<std::vector<cv::Point>> &contours);
+
+    void updateTrailMesh(const std::vector<ofVec3f> &trail, int trail_position);
+
+    static const int CIRCLE_RESOLUTION = 20;
+
+    // Tracking thread
+    uint64_t last_update_us = 0;
+
+    // Shared
+    std::mutex mutex;
+    Snapshot snapshot;
+    bool has_snapshot = false;
+    std::atomic<bool> enabled{true};
+
+    // Render thread
+    Snapshot uploaded;
+    ofTexture texture;
+    ofVboMesh contour_mesh;
+    ofVboMesh trail_mesh;
+    bool has_frame = false;
+    bool has_texture = false;
+
+};
@@ -0,0 +1,233 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "PreviewStreamer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+
+#ifdef __APPLE__
+#include <pthread/qos.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+static const char *STREAM_HEADER =
+        "HTTP/1.0 200 OK\r\n"
+        "Cache-Control: no-cache\r\n"
+        "Connection: close\r\n"
+        "Content-Type: multipart/x-mixed-replace; boundary=frame\r\n"
+        "\r\n";
+
+PreviewStreamer::~PreviewStreamer() {
+    stop();
+}
+
+bool PreviewStreamer::start(int port) {
+    stop();
+
+    listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (listen_fd < 0) {
+        return false;
+    }
+    int yes = 1;
+    setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(static_cast<uint16_t>(port));
+    if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 || listen(listen_fd, 4) != 0) {
+        close(listen_fd);
+        listen_fd = -1;
+        return false;
+    }
+
+    running = true;
+    server = std::thread(&PreviewStreamer::serverFunction, this);
+    encoder = std::thread(&PreviewStreamer::encoderFunction, this);
+    return true;
+}
+
+void PreviewStreamer::stop() {
+    if (!running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(frame_mutex);
+        running = false;
+    }
+    frame_cv.notify_one();
+    server.join();
+    encoder.join();
+
+    close(listen_fd);
+    listen_fd = -1;
+    std::lock_guard<std::mutex> lock(clients_mutex);
+    for (int fd : clients) {
+        close(fd);
+    }
+    clients.clear();
+    num_clients = 0;
+}
+
+bool PreviewStreamer::isRunning() const {
+    return running;
+}
+
+int PreviewStreamer::getNumClients() const {
+    return num_clients;
+}
+
+void PreviewStreamer::submit(const cv::Mat &rgb, const std::vector<std::vector<cv::Point>> &contours,
+                             cv::Point2f cursor, float scale, int max_fps, int quality) {
+
+    // Costs nothing when nobody is watching.
+    if (num_clients == 0 || max_fps <= 0) {
+        return;
+    }
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_submit < std::chrono::microseconds(1000000 / max_fps)) {
+        return;
+    }
+
+    // Skip the frame rather than wait for the encoder.
+    std::unique_lock<std::mutex> lock(frame_mutex, std::try_to_lock);
+    if (!lock.owns_lock() || frame_ready) {
+        return;
+    }
+    rgb.copyTo(frame);
+    frame_contours = contours;
+    frame_cursor = cursor;
+    frame_scale = scale;
+    frame_quality = quality;
+    frame_ready = true;
+    last_submit = now;
+    lock.unlock();
+    frame_cv.notify_one();
+}
+
+//--------------------------------------------------------------
+
+void PreviewStreamer::serverFunction() {
+    while (running) {
+        pollfd p;
+        p.fd = listen_fd;
+        p.events = POLLIN;
+        if (poll(&p, 1, 200) <= 0) {
+            continue;
+        }
+        const int fd = accept(listen_fd, nullptr, nullptr);
+        if (fd < 0) {
+            continue;
+        }
+
+        // Any request gets the stream, read and discard it.
+        timeval timeout;
+        timeout.tv_sec = 1;
+        timeout.tv_usec = 0;
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#ifdef SO_NOSIGPIPE
+        int no_sigpipe = 1;
+        setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &no_sigpipe, sizeof(no_sigpipe));
+#endif
+        char request[1024];
+        if (recv(fd, request, sizeof(request), 0) <= 0 ||
+                send(fd, STREAM_HEADER, std::strlen(STREAM_HEADER), MSG_NOSIGNAL) < 0) {
+            close(fd);
+            continue;
+        }
+
+        std::lock_guard<std::mutex> lock(clients_mutex);
+        clients.push_back(fd);
+        num_clients = static_cast<int>(clients.size());
+    }
+}
+
+void PreviewStreamer::encoderFunction() {
+#if defined(__linux__)
+    sched_param param;
+    param.sched_priority = 0;
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#elif defined(__APPLE__)
+    pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#endif
+
+    cv::Mat pending;
+    cv::Mat small;
+    cv::Mat bgr;
+    std::vector<unsigned char> jpeg;
+    std::vector<std::vector<cv::Point>> contours;
+    cv::Point2f cursor;
+
+    while (true) {
+        float scale;
+        int quality;
+        {
+            std::unique_lock<std::mutex> lock(frame_mutex);
+            frame_cv.wait(lock, [&] { return frame_ready || !running; });
+            if (!running) {
+                break;
+            }
+            // Swap the snapshot out, so the buffers are reused and the lock is held only briefly.
+            cv::swap(frame, pending);
+            contours.swap(frame_contours);
+            cursor = frame_cursor;
+            scale = std::min(1.0f, std::max(0.05f, frame_scale));
+            quality = frame_quality;
+            frame_ready = false;
+        }
+
+        cv::resize(pending, small, cv::Size(), scale, scale, cv::INTER_AREA);
+        for (std::vector<cv::Point> &contour : contours) {
+            for (cv::Point &p : contour) {
+                p = cv::Point(cvRound(p.x * scale), cvRound(p.y * scale));
+            }
+        }
+        if (cursor.x >= 0) {
+            const cv::Point c(cvRound(cursor.x * scale), cvRound(cursor.y * scale));
+            cv::circle(small, c, 6, cv::Scalar(0, 0, 0), cv::FILLED);
+            cv::circle(small, c, 4, cv::Scalar(255, 255, 255), cv::FILLED);
+        }
+        cv::polylines(small, contours, true, cv::Scalar::all(255));
+        cv::cvtColor(small, bgr, cv::COLOR_RGB2BGR);
+        cv::imencode(".jpg", bgr, jpeg, {cv::IMWRITE_JPEG_QUALITY, quality});
+        sendToClients(jpeg);
+    }
+}
+
+void PreviewStreamer::sendToClients(const std::vector<unsigned char> &jpeg) {
+    const std::string part = "--frame\r\nContent-Type: image/jpeg\r\nContent-Length: " +
+                             std::to_string(jpeg.size()) + "\r\n\r\n";
+
+    std::lock_guard<std::mutex> lock(clients_mutex);
+    for (auto it = clients.begin(); it != clients.end();) {
+        const bool ok = send(*it, part.data(), part.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(part.size()) &&
+                        send(*it, jpeg.data(), jpeg.size(), MSG_NOSIGNAL) == static_cast<ssize_t>(jpeg.size()) &&
+                        send(*it, "\r\n", 2, MSG_NOSIGNAL) == 2;
+        if (ok) {
+            ++it;
+        } else {
+            // Client went away or cannot keep up, drop it.
+            close(*it);
+            it = clients.erase(it);
+        }
+    }
+    num_clients = static_cast<int>(clients.size());
+}
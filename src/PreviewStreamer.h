@@ -0,0 +1,69 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+/**
+ * Serves the annotated camera frame as an MJPEG stream over HTTP, for headless deployments.
+ *
+ * The HTTP server and the JPEG encoder run on their own threads, the encoder at the lowest scheduling
+ * priority. submit() returns immediately when nobody is connected or the stream rate is reached, and never
+ * waits for the encoder: if the encoder is still busy with the previous frame, the frame is skipped.
+ */
+class PreviewStreamer {
+
+public:
+
+    ~PreviewStreamer();
+
+    bool start(int port);
+
+    void stop();
+
+    bool isRunning() const;
+
+    int getNumClients() const;
+
+    void submit(const cv::Mat &rgb, const std::vector<std::vector<cv::Point>> &contours, cv::Point2f cursor,
+                float scale, int max_fps, int quality);
+
+private:
+
+    void serverFunction();
+
+    void encoderFunction();
+
+    void sendToClients(const std::vector<unsigned char> &jpeg);
+
+    int listen_fd = -1;
+    std::thread server;
+    std::thread encoder;
+    std::atomic<bool> running{false};
+
+    std::mutex clients_mutex;
+    std::vector<int> clients;
+    std::atomic<int> num_clients{0};
+
+    // Snapshot handed from the tracking thread to the encoder.
+    std::mutex frame_mutex;
+    std::condition_variable frame_cv;
+    cv::Mat frame;
+    std::vector<std::vector<cv::Point>> frame_contours;
+    cv::Point2f frame_cursor;
+    float frame_scale = 0.5f;
+    int frame_quality = 70;
+    bool frame_ready = false;
+
+    std::chrono::steady_clock::time_point last_submit;
+
+};
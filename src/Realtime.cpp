@@ -0,0 +1,90 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "Realtime.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+bool Realtime::applyToCurrentThread(const RealtimeOptions &options, std::string &message) {
+#ifdef __linux__
+    bool ok = true;
+    message.clear();
+
+    // CPU affinity
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    const long num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (options.cpu >= 0 && options.cpu < num_cpus) {
+        CPU_SET(options.cpu, &cpus);
+    } else {
+        for (long i = 0; i < num_cpus; i++) {
+            CPU_SET(i, &cpus);
+        }
+        if (options.cpu >= num_cpus) {
+            message += "CPU " + std::to_string(options.cpu) + " does not exist, not pinned. ";
+            ok = false;
+        }
+    }
+    const int affinity_error = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+    if (affinity_error != 0) {
+        message += "Cannot set CPU affinity: " + std::string(strerror(affinity_error)) + ". ";
+        ok = false;
+    }
+
+    // Scheduling policy, falls back to normal scheduling if real-time scheduling is not permitted.
+    sched_param param;
+    std::memset(&param, 0, sizeof(param));
+    int policy = SCHED_OTHER;
+    if (options.priority > 0) {
+        policy = SCHED_FIFO;
+        param.sched_priority = std::min(options.priority, sched_get_priority_max(SCHED_FIFO));
+    }
+    const int sched_error = pthread_setschedparam(pthread_self(), policy, &param);
+    if (sched_error == EPERM) {
+        message += "No permission for SCHED_FIFO, using normal scheduling. "
+                   "Grant CAP_SYS_NICE or set rtprio in /etc/security/limits.conf. ";
+        ok = false;
+    } else if (sched_error != 0) {
+        message += "Cannot set scheduling policy: " + std::string(strerror(sched_error)) + ". ";
+        ok = false;
+    }
+    return ok;
+#else
+    message = "Real-time scheduling is only supported on Linux.";
+    return options.cpu < 0 && options.priority <= 0;
+#endif
+}
+
+/**
+ * Locks the pages the process has mapped now in RAM, so the frame buffers allocated at setup never page fault.
+ * Later mappings are not locked: with MCL_FUTURE, every memory-mapped recording would be read into RAM and
+ * pinned there, and mapping would fail as soon as the memlock limit is reached.
+ */
+bool Realtime::lockMemory(bool lock, std::string &message) {
+#ifdef __linux__
+    message.clear();
+    if (!lock) {
+        munlockall();
+        return true;
+    }
+    if (mlockall(MCL_CURRENT) != 0) {
+        message = "Cannot lock memory: " + std::string(strerror(errno)) +
+                  ". Raise memlock in /etc/security/limits.conf or grant CAP_IPC_LOCK.";
+        return false;
+    }
+    return true;
+#else
+    message = "Locking memory is only supported on Linux.";
+    return !lock;
+#endif
+}
@@ -0,0 +1,30 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <string>
+
+/**
+ * Real-time scheduling options for the threads that track and send output.
+ */
+struct RealtimeOptions {
+    int cpu = -1;               // CPU to pin the thread to, -1 for any CPU
+    int priority = 0;           // SCHED_FIFO priority 1..99, 0 for normal scheduling
+};
+
+/**
+ * Applies real-time scheduling options. Supported on Linux only, elsewhere the calls report an error and
+ * leave the scheduling untouched. Missing permissions are not fatal: the thread keeps running with normal
+ * scheduling and the returned message explains how to grant the permission.
+ */
+class Realtime {
+
+public:
+
+    static bool applyToCurrentThread(const RealtimeOptions &options, std::string &message);
+
+    static bool lockMemory(bool lock, std::string &message);
+
+};
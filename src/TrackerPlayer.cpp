@@ -0,0 +1,150 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "TrackerPlayer.h"
+
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+TrackerPlayer::~TrackerPlayer() {
+    stop();
+    unload();
+}
+
+bool TrackerPlayer::load(const std::string &path) {
+    stop();
+    unload();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        ofLogError("TrackerPlayer") << "Cannot open " << path;
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TrackerLogHeader)) {
+        ofLogError("TrackerPlayer") << "Not a tracker log: " << path;
+        ::close(fd);
+        return false;
+    }
+    mapping_size = static_cast<size_t>(st.st_size);
+    mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        mapping = nullptr;
+        ofLogError("TrackerPlayer") << "Cannot map " << path;
+        return false;
+    }
+
+    const TrackerLogHeader *header = static_cast<const TrackerLogHeader *>(mapping);
+    if (std::memcmp(header->magic, TRACKER_LOG_MAGIC, sizeof(header->magic)) != 0 ||
+            header->version != TRACKER_LOG_VERSION ||
+            header->record_size != sizeof(TrackerRecord)) {
+        ofLogError("TrackerPlayer") << "Unsupported tracker log: " << path;
+        unload();
+        return false;
+    }
+
+    // Playback is sequential, let the OS read ahead.
+    madvise(mapping, mapping_size, MADV_SEQUENTIAL);
+
+    records = reinterpret_cast<const TrackerRecord *>(static_cast<const unsigned char *>(mapping) + sizeof(TrackerLogHeader));
+    num_records = (mapping_size - sizeof(TrackerLogHeader)) / sizeof(TrackerRecord);
+    ofLogNotice("TrackerPlayer") << "Loaded " << path << " with " << num_records << " records.";
+    return true;
+}
+
+void TrackerPlayer::play(const std::string &server, int port, const std::string &address, float speed,
+                         const RealtimeOptions &realtime) {
+    if (records == nullptr) {
+        return;
+    }
+    stop();
+    sender.setup(server, port);
+    this->address = address;
+    this->speed = speed > 0.0f ? speed : 1.0f;
+    this->realtime = realtime;
+    startThread();
+}
+
+void TrackerPlayer::stop() {
+    if (isThreadRunning()) {
+        stopThread();
+    }
+    waitForThread(false);
+}
+
+bool TrackerPlayer::isPlaying() const {
+    return isThreadRunning();
+}
+
+size_t TrackerPlayer::getNumRecords() const {
+    return num_records;
+}
+
+//--------------------------------------------------------------
+
+void TrackerPlayer::threadedFunction() {
+    // The replay thread owns the OSC output, so it gets the same scheduling as the tracking thread.
+    std::string message;
+    if (!Realtime::applyToCurrentThread(realtime, message)) {
+        ofLogWarning("TrackerPlayer") << message;
+    }
+
+    const uint64_t t0 = ofGetElapsedTimeMicros();
+    uint64_t first_timestamp = 0;
+    bool first = true;
+
+    for (size_t i = 0; i < num_records && isThreadRunning(); i++) {
+        const TrackerRecord &r = records[i];
+        if (r.type == TRACKER_RECORD_NONE) {
+            // End of a log that was not closed cleanly.
+            break;
+        }
+        if (r.type != TRACKER_RECORD_FRAME) {
+            continue;
+        }
+        if (first) {
+            first_timestamp = r.timestamp_us;
+            first = false;
+        }
+
+        const uint64_t due = t0 + static_cast<uint64_t>((r.timestamp_us - first_timestamp) / speed);
+        const uint64_t now = ofGetElapsedTimeMicros();
+        if (due > now) {
+            ofSleepMillis(static_cast<int>((due - now) / 1000));
+        }
+
+        if (r.pos[0] != -1) {
+            ofxOscMessage m;
+            m.setAddress(address);
+            for (float v : r.pos) {
+                m.addFloatArg(v);
+            }
+            for (float v : r.vel) {
+                m.addFloatArg(v);
+            }
+            for (float v : r.acc) {
+                m.addFloatArg(v);
+            }
+            sender.sendMessage(m, false);
+        }
+    }
+    ofLogNotice("TrackerPlayer") << "Replay finished.";
+
+    // Release the mapping, nothing else reads it until the next load().
+    unload();
+}
+
+void TrackerPlayer::unload() {
+    if (mapping != nullptr) {
+        munmap(mapping, mapping_size);
+    }
+    mapping = nullptr;
+    mapping_size = 0;
+    records = nullptr;
+    num_records = 0;
+}
@@ -0,0 +1,55 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+#include "Realtime.h"
+#include "TrackerRecord.h"
+
+/**
+ * Replays a tracker output log (*.octlog) over OSC on a background thread.
+ *
+ * The log is memory-mapped read-only, so sessions of any length are streamed from disk and never loaded
+ * into RAM. Frames are re-emitted with their original timing, scaled by the replay speed. The log is unmapped
+ * when the replay finishes or is stopped, so load() it again to replay it once more.
+ */
+class TrackerPlayer : public ofThread {
+
+public:
+
+    ~TrackerPlayer();
+
+    bool load(const std::string &path);
+
+    void play(const std::string &server, int port, const std::string &address, float speed,
+              const RealtimeOptions &realtime = RealtimeOptions());
+
+    void stop();
+
+    bool isPlaying() const;
+
+    size_t getNumRecords() const;
+
+protected:
+
+    void threadedFunction() override;
+
+private:
+
+    void unload();
+
+    const TrackerRecord *records = nullptr;
+    size_t num_records = 0;
+    void *mapping = nullptr;
+    size_t mapping_size = 0;
+
+    ofxOscSender sender;
+    std::string address;
+    float speed = 1.0f;
+    RealtimeOptions realtime;
+
+};
@@ -0,0 +1,46 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * On-disk layout of a tracker output log (*.octlog).
+ *
+ * The file starts with a TrackerLogHeader, followed by fixed-size TrackerRecords. Every frame produces one
+ * FRAME record with the tracker state (pos, vel, acc) and one BLOB record per blob that is within the
+ * configured area range. Records with type NONE mark the unused tail of a log that was not closed cleanly.
+ */
+
+static const char TRACKER_LOG_MAGIC[8] = {'O', 'C', 'T', 'L', 'O', 'G', '0', '1'};
+static const uint32_t TRACKER_LOG_VERSION = 1;
+
+struct TrackerLogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_size;
+    uint64_t start_time_us;     // wall clock time of the first record, in microseconds since epoch
+    uint8_t reserved[40];
+};
+
+enum TrackerRecordType : uint16_t {
+    TRACKER_RECORD_NONE = 0,
+    TRACKER_RECORD_FRAME = 1,
+    TRACKER_RECORD_BLOB = 2
+};
+
+struct TrackerRecord {
+    uint64_t timestamp_us;      // time since start of the recording, in microseconds
+    uint32_t frame;
+    uint16_t type;
+    uint16_t blob_index;
+    float pos[3];               // FRAME: normalized position; BLOB: normalized center and area
+    float vel[3];               // FRAME only
+    float acc[3];               // FRAME only
+    uint8_t reserved[12];
+};
+
+static_assert(sizeof(TrackerLogHeader) == 64, "TrackerLogHeader must be 64 bytes");
+static_assert(sizeof(TrackerRecord) == 64, "TrackerRecord must be 64 bytes");
@@ -0,0 +1,269 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#include "TrackerRecorder.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+TrackerRecorder::TrackerRecorder() = default;
+
+TrackerRecorder::~TrackerRecorder() {
+    close();
+}
+
+bool TrackerRecorder::open(const std::string &path) {
+    close();
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        error = "Cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    this->path = path;
+    chunk_index = 0;
+    count = 0;
+    frame = 0;
+    frame_time_us = 0;
+    requested_chunk = 0;
+    prepared_chunk = 0;
+    prepared_ready = false;
+    failed = false;
+    num_dropped = 0;
+    error.clear();
+
+    // The first chunk is mapped here, the mapper thread maps all following chunks ahead of time.
+    if (!mapChunk(0, current, error)) {
+        ::close(fd);
+        fd = -1;
+        return false;
+    }
+
+    TrackerLogHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, TRACKER_LOG_MAGIC, sizeof(header.magic));
+    header.version = TRACKER_LOG_VERSION;
+    header.record_size = sizeof(TrackerRecord);
+    header.start_time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    std::memcpy(current.mapping, &header, sizeof(header));
+
+    running = true;
+    mapper = std::thread(&TrackerRecorder::mapperFunction, this);
+
+    start = std::chrono::steady_clock::now();
+    return true;
+}
+
+/**
+ * Closes the log. Returns false, with the reason in getError(), if the unused tail could not be cut off.
+ * The reader stops at the first empty record, so the log is still valid in that case.
+ */
+bool TrackerRecorder::close() {
+    if (mapper.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+        }
+        cv.notify_one();
+        mapper.join();
+    }
+    unmapChunk(current);
+    unmapChunk(prepared);
+    unmapChunk(retired);
+    prepared_ready = false;
+    bool ok = true;
+    if (fd >= 0) {
+        // Cut off the unused part of the last chunk.
+        if (ftruncate(fd, static_cast<off_t>(sizeof(TrackerLogHeader) +
+                (chunk_index * CHUNK_RECORDS + count) * sizeof(TrackerRecord))) != 0) {
+            error = "Cannot truncate " + path + ": " + std::strerror(errno);
+            ok = false;
+        }
+        ::close(fd);
+        fd = -1;
+    }
+    return ok;
+}
+
+bool TrackerRecorder::isOpen() const {
+    return current.mapping != nullptr;
+}
+
+bool TrackerRecorder::hasFailed() const {
+    return failed;
+}
+
+std::string TrackerRecorder::getError() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+const std::string &TrackerRecorder::getPath() const {
+    return path;
+}
+
+uint64_t TrackerRecorder::getNumDroppedRecords() const {
+    return num_dropped;
+}
+
+void TrackerRecorder::beginFrame() {
+    frame++;
+    frame_time_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start).count());
+}
+
+void TrackerRecorder::appendFrame(const float pos[3], const float vel[3], const float acc[3]) {
+    TrackerRecord *r = next();
+    if (r == nullptr) {
+        return;
+    }
+    r->timestamp_us = frame_time_us;
+    r->frame = frame;
+    r->type = TRACKER_RECORD_FRAME;
+    r->blob_index = 0;
+    std::memcpy(r->pos, pos, sizeof(r->pos));
+    std::memcpy(r->vel, vel, sizeof(r->vel));
+    std::memcpy(r->acc, acc, sizeof(r->acc));
+}
+
+void TrackerRecorder::appendBlob(int blob_index, const float pos[3]) {
+    TrackerRecord *r = next();
+    if (r == nullptr) {
+        return;
+    }
+    r->timestamp_us = frame_time_us;
+    r->frame = frame;
+    r->type = TRACKER_RECORD_BLOB;
+    r->blob_index = static_cast<uint16_t>(blob_index);
+    std::memcpy(r->pos, pos, sizeof(r->pos));
+}
+
+//--------------------------------------------------------------
+
+TrackerRecord *TrackerRecorder::next() {
+    if (current.mapping == nullptr || failed) {
+        return nullptr;
+    }
+    if (count == CHUNK_RECORDS) {
+        // Switch to the chunk the mapper has prepared, never wait for it.
+        if (!prepared_ready.load(std::memory_order_acquire)) {
+            num_dropped++;
+            return nullptr;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (retired.mapping != nullptr) {
+                num_dropped++;
+                return nullptr;
+            }
+            retired = current;
+            current = prepared;
+            prepared = Chunk();
+            prepared_ready = false;
+        }
+        cv.notify_one();
+        chunk_index++;
+        count = 0;
+    }
+    if (count == CHUNK_RECORDS / 2) {
+        // Half way through the chunk, ask the mapper for the next one.
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            requested_chunk = chunk_index + 1;
+        }
+        cv.notify_one();
+    }
+    return current.records + count++;
+}
+
+void TrackerRecorder::mapperFunction() {
+    while (true) {
+        Chunk to_unmap;
+        size_t to_map = 0;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] {
+                return !running || retired.mapping != nullptr || requested_chunk > prepared_chunk;
+            });
+            if (!running && retired.mapping == nullptr) {
+                break;
+            }
+            std::swap(to_unmap, retired);
+            if (running && requested_chunk > prepared_chunk) {
+                to_map = requested_chunk;
+                prepared_chunk = requested_chunk;
+            }
+        }
+
+        unmapChunk(to_unmap);
+        if (to_map > 0) {
+            Chunk chunk;
+            std::string message;
+            const bool ok = mapChunk(to_map, chunk, message);
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok) {
+                prepared = chunk;
+                prepared_ready.store(true, std::memory_order_release);
+            } else {
+                error = message;
+                failed = true;
+            }
+        }
+    }
+}
+
+/**
+ * Grows the file to hold chunk index, maps it and faults in all its pages. Chunk sizes are a multiple of
+ * the page size, so each mapping starts at the page aligned offset index * chunk size and includes the
+ * 64 bytes before the first record of the chunk, which is the file header for chunk 0.
+ */
+bool TrackerRecorder::mapChunk(size_t index, Chunk &chunk, std::string &message) {
+    const size_t chunk_size = CHUNK_RECORDS * sizeof(TrackerRecord);
+    const size_t file_size = sizeof(TrackerLogHeader) + (index + 1) * chunk_size;
+
+    // The grown part is zero filled, which reads as empty records.
+#ifdef __linux__
+    // Reserve the disk blocks now, so storing a record does not have to allocate them.
+    const int result = posix_fallocate(fd, 0, static_cast<off_t>(file_size));
+    if (result != 0) {
+        message = "Cannot grow " + path + ": " + std::strerror(result);
+        return false;
+    }
+#else
+    if (ftruncate(fd, static_cast<off_t>(file_size)) != 0) {
+        message = "Cannot grow " + path + ": " + std::strerror(errno);
+        return false;
+    }
+#endif
+    const size_t length = sizeof(TrackerLogHeader) + chunk_size;
+    void *p = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, static_cast<off_t>(index * chunk_size));
+    if (p == MAP_FAILED) {
+        message = "Cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    chunk.mapping = static_cast<unsigned char *>(p);
+    chunk.length = length;
+    chunk.records = reinterpret_cast<TrackerRecord *>(chunk.mapping + sizeof(TrackerLogHeader));
+
+    // Take the write fault of every page here instead of on the first record stored in it. MAP_POPULATE
+    // would only map the pages for reading. Only bytes of this chunk's own, still empty, records are touched.
+    const long page_size = sysconf(_SC_PAGESIZE);
+    volatile unsigned char *records = reinterpret_cast<unsigned char *>(chunk.records);
+    for (size_t offset = 0; offset < chunk_size; offset += static_cast<size_t>(page_size)) {
+        records[offset] = 0;
+    }
+    records[chunk_size - 1] = 0;
+    return true;
+}
+
+void TrackerRecorder::unmapChunk(Chunk &chunk) {
+    if (chunk.mapping != nullptr) {
+        munmap(chunk.mapping, chunk.length);
+    }
+    chunk = Chunk();
+}
@@ -0,0 +1,98 @@
+//
+// Created by G.F. Duivesteijn on 18/10/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "TrackerRecord.h"
+
+/**
+ * Appends tracker output to a memory-mapped, append-only binary log.
+ *
+ * Appending a record is a plain store into the mapping; the OS writes the pages back in the background.
+ * The file is mapped in large chunks. A mapper thread reserves the disk blocks for the next chunk, maps it
+ * and faults in its pages while the current one is half full, and unmaps finished chunks, so the tracking
+ * thread never waits for a system call or a page fault.
+ * If the next chunk is not ready in time, records are dropped and counted. If mapping fails, hasFailed()
+ * returns true and getError() tells why; the same holds when close() returns false. Call all methods from
+ * one thread.
+ */
+class TrackerRecorder {
+
+public:
+
+    TrackerRecorder();
+
+    ~TrackerRecorder();
+
+    bool open(const std::string &path);
+
+    bool close();
+
+    bool isOpen() const;
+
+    bool hasFailed() const;
+
+    std::string getError();
+
+    const std::string &getPath() const;
+
+    uint64_t getNumDroppedRecords() const;
+
+    void beginFrame();
+
+    void appendFrame(const float pos[3], const float vel[3], const float acc[3]);
+
+    void appendBlob(int blob_index, const float pos[3]);
+
+private:
+
+    // 1M records of 64 bytes, about 2 hours of tracking at 30fps with a handful of blobs per frame.
+    static const size_t CHUNK_RECORDS = 1 << 20;
+
+    struct Chunk {
+        unsigned char *mapping = nullptr;
+        size_t length = 0;
+        TrackerRecord *records = nullptr;
+    };
+
+    bool mapChunk(size_t index, Chunk &chunk, std::string &message);
+
+    static void unmapChunk(Chunk &chunk);
+
+    void mapperFunction();
+
+    TrackerRecord *next();
+
+    std::string path;
+    int fd = -1;
+    Chunk current;
+    size_t chunk_index = 0;
+    size_t count = 0;
+    uint32_t frame = 0;
+    uint64_t frame_time_us = 0;
+    std::chrono::steady_clock::time_point start;
+
+    // Shared with the mapper thread.
+    std::thread mapper;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool running = false;
+    size_t requested_chunk = 0;
+    size_t prepared_chunk = 0;
+    Chunk prepared;
+    Chunk retired;
+    std::atomic<bool> prepared_ready{false};
+    std::atomic<bool> failed{false};
+    std::string error;
+    std::atomic<uint64_t> num_dropped{0};
+
+};
@@ -22,63 +22,138 @@ void ofApp::setup() {
 
     ofSetFrameRate(static_cast<int>(fps.get()));
     ofSetVerticalSync(true);
+
+    // Last, so that locking memory covers all buffers allocated above
+    loadRealtimeSettings();
+
+    // Tracking and OSC output run on their own thread, apart from rendering
+    osc_address = msg.get();
+    startThread();
 }
 
 void ofApp::update() {
-    
-    if (videoGrabber == nullptr) {
-        return;
+
+    // Move the latest preview snapshot of the tracking thread to the GPU
+    preview_renderer.upload();
+
+    // Apply the calibration from the tuner when it has finished
+    TunerResult tuned;
+    if (calibration_tuner.takeResult(tuned)) {
+        lock();
+        applyTunerResult(tuned);
+        unlock();
     }
+}
 
-    // read next frame from camera
-    videoGrabber->update();
+void ofApp::threadedFunction() {
+    while (isThreadRunning()) {
+        if (realtime_changed.exchange(false)) {
+            applyRealtimeOptions();
+        }
+
+        lock();
+        const bool tracked = updateTracking();
+        unlock();
+
+        // Wait for the next camera frame without spinning, also with real-time priority
+        if (!tracked) {
+            std::this_thread::sleep_for(std::chrono::microseconds(250));
+        }
+    }
+}
 
-    if (videoGrabber->isFrameNew()) {
+/**
+ * Tracks the object in the next frame and sends the OSC output. Returns false if there was no new frame.
+ */
+bool ofApp::updateTracking() {
 
-        updateFilterMasks();
+    // Collect the latencies measured by the loopback receiver
+    if (loopback_test.get()) {
+        for (int64_t latency_us : loopback_probe.takeLatencies()) {
+            latency_tracer.addLoopbackLatency(latency_us);
+        }
+    }
+
+    // read next frame from camera or from the recorded session
+    if (!updateFrameSource()) {
+        return false;
+    }
 
-        // Find contours of colour patches within calibrated range
-        cv::findContours(ftr, allContours, contourFindingMode, simplifyMode);
+    // Start the trace context of this frame at its capture time
+    latency_tracer.begin(frame_capture_time);
 
-        // Compute center and area of all closed contours,
-        // updates moments (mu), mass centers (mc), max_area and argmax_area.
-        find_blobs();
+    // Measure the tracking rate, for velocity and acceleration
+    updateFrameInterval();
 
-        // Update ring buffer position
-        buffer_position = (buffer_position + 1) % buffer_size;
+    updateFilterMasks();
+    latency_tracer.mark(TRACE_FILTER);
 
-        // Update object location, if applicable
-        updateObjectLocation();
+    // Find contours of colour patches within calibrated range
+    cv::findContours(ftr, allContours, contourFindingMode, simplifyMode);
+    latency_tracer.mark(TRACE_CONTOURS);
 
+    // Compute center and area of all closed contours,
+    // updates moments (mu), mass centers (mc), max_area and argmax_area.
+    find_blobs();
+    latency_tracer.mark(TRACE_BLOBS);
+
+    // Update ring buffer position
+    buffer_position = (buffer_position + 1) % buffer_size;
+
+    // Update object location, if applicable
+    updateObjectLocation();
+    latency_tracer.mark(TRACE_LOCATION);
+
+    // Append tracker state and blobs to the output log, if recording
+    recordTrackerOutput();
+
+    // The replay thread owns the OSC output while it is running
+    if (!tracker_player.isPlaying()) {
         sendOscMessage();
     }
+    latency_tracer.end();
+
+    // Copy the camera frame to the recorder only after the OSC output has been sent
+    if (frame_recorder.isOpen() && !frame_source.isOpen()) {
+        const ofPixels &pixels = videoGrabber->getPixels();
+        frame_recorder.push(pixels.getData(), pixels.size(), frame_capture_time);
+    }
+
+    // Take a snapshot for the preview, at the preview rate
+    if (preview_renderer.isDue(preview_fps.get())) {
+        preview_renderer.update(rgb, allContours, buffer, buffer_position, show_webcam_view.get(),
+                                show_contours.get(), one_blob_only.get() && show_trail.get());
+    }
+
+    // Hand the frame to the remote preview stream, returns immediately if nobody is watching
+    if (stream_enabled.get()) {
+        const cv::Point2f cursor = pos.x != -1 ? cv::Point2f(pos.x * rgb.cols, pos.y * rgb.rows) : cv::Point2f(-1, -1);
+        preview_streamer.submit(rgb, allContours, cursor, stream_scale.get(), stream_fps.get(), stream_quality.get());
+    }
+    return true;
 }
 
 void ofApp::draw() {
 
     ofBackground(64, 64, 64);
-    
-    // Draw contours
-    if (show_contours.get()) {
-        cv::drawContours(rgb, allContours, -1, cv::Scalar::all(255));
-    }
 
-    // Draw webcam feed
-    if (show_webcam_view.get()) {
-        ofxCv::drawMat(rgb, 0, 0);
-    }
+    // Draw webcam feed and contours from the last preview snapshot
+    preview_renderer.drawPreview(show_webcam_view.get(), show_contours.get());
 
     // Draw Settings Panel
     if (showGui) {
         gui.draw();
     }
 
+    // The cursor, status and recording messages show the state of the tracking thread
+    lock();
+
     // Show only the largest blob or all blobs within range of area from settings.
     drawObjectCursor();
 
     // Draw trail from object
     if (one_blob_only.get() && show_trail.get()) {
-        drawTrail();
+        preview_renderer.drawTrail();
     }
 
     // Draw mouse cursor with calibration patch size
@@ -88,11 +163,34 @@ void ofApp::draw() {
         drawStatusMessage(buffer.at(static_cast<unsigned long>(buffer_position)));
     }
 
+    if (tracker_recorder.isOpen() || frame_recorder.isOpen() || frame_source.isOpen() ||
+            calibration_tuner.isRunning()) {
+        drawRecordingMessage();
+    }
+
+    unlock();
+
     if (show_help.get()) {
         drawHelpPanel();
     }
 }
 
+void ofApp::exit() {
+    stopThread();
+    waitForThread(false);
+    calibration_tuner.cancel();
+    preview_streamer.stop();
+    loopback_probe.stop();
+    tracker_player.stop();
+    if (tracker_recorder.isOpen()) {
+        toggleTrackerRecording();
+    }
+    if (frame_recorder.isOpen()) {
+        toggleFrameRecording();
+    }
+    frame_source.close();
+}
+
 //--------------------------------------------------------------
 
 void ofApp::setupCamera() {
@@ -107,6 +205,8 @@ void ofApp::setupCamera() {
         }
     }
     videoGrabber->setDeviceID(0);
+    // The grabber is updated on the tracking thread, which has no GL context; the preview has its own texture.
+    videoGrabber->setUseTexture(false);
     videoGrabber->setup(camWidth, camHeight);
 }
 
@@ -117,16 +217,18 @@ void ofApp::setupRingBuffer() {
 }
 
 void ofApp::setupImageBuffers() {
-    rgb = cv::Mat(camWidth, camHeight, CV_8UC3);
-    rgbm = cv::Mat(camWidth, camHeight, CV_8UC3);
-    hsb = cv::Mat(camWidth, camHeight, CV_8UC3);
-    h = cv::Mat(camWidth, camHeight, CV_8UC1);
-    s = cv::Mat(camWidth, camHeight, CV_8UC1);
-    b = cv::Mat(camWidth, camHeight, CV_8UC1);
-    maskH = cv::Mat(camWidth, camHeight, CV_8UC1);
-    maskS = cv::Mat(camWidth, camHeight, CV_8UC1);
-    maskV = cv::Mat(camWidth, camHeight, CV_8UC1);
-    ftr = cv::Mat(camWidth, camHeight, CV_8UC1);
+    // Allocated at frame size, so the pipeline reuses them instead of allocating per frame,
+    // and zero filled, so their pages are faulted in before tracking starts.
+    rgb = cv::Mat::zeros(camHeight, camWidth, CV_8UC3);
+    rgbm = cv::Mat::zeros(camHeight, camWidth, CV_8UC3);
+    hsb = cv::Mat::zeros(camHeight, camWidth, CV_8UC3);
+    h = cv::Mat::zeros(camHeight, camWidth, CV_8UC1);
+    s = cv::Mat::zeros(camHeight, camWidth, CV_8UC1);
+    b = cv::Mat::zeros(camHeight, camWidth, CV_8UC1);
+    maskH = cv::Mat::zeros(camHeight, camWidth, CV_8UC1);
+    maskS = cv::Mat::zeros(camHeight, camWidth, CV_8UC1);
+    maskV = cv::Mat::zeros(camHeight, camWidth, CV_8UC1);
+    ftr = cv::Mat::zeros(camHeight, camWidth, CV_8UC1);
 }
 
 void ofApp::setupGui() {
@@ -157,10 +259,41 @@ void ofApp::setupGui() {
     comm_settings_group.add(server.set("Server", "localhost"));
     comm_settings_group.add(port.set("Port", "6448"));
     comm_settings_group.add(msg.set("Message", "/wek/inputs"));
+    comm_settings_group.add(osc_schema.set("OSC schema", "pos,vel,acc"));
+    osc_features = BlobFeatures::parseSchema(osc_schema.get());
+    osc_schema.addListener(this, &ofApp::oscSchemaChanged);
+
+    latency_group.setName("Latency");
+    latency_group.add(send_capture_timestamp.set("Send capture timestamp", false));
+    latency_group.add(loopback_test.set("Loopback test", false));
+    latency_group.add(loopback_port.set("Loopback port", "6449"));
+    loopback_test.addListener(this, &ofApp::loopbackTestChanged);
+    loopback_port.addListener(this, &ofApp::loopbackPortChanged);
+
+    realtime_group.setName("Real-time");
+    realtime_group.add(realtime_cpu.set("Tracking CPU", -1, -1, 63));
+    realtime_group.add(realtime_priority.set("SCHED_FIFO priority", 0, 0, 99));
+    realtime_group.add(lock_memory.set("Lock memory", false));
+    realtime_cpu.addListener(this, &ofApp::realtimeChanged);
+    realtime_priority.addListener(this, &ofApp::realtimeChanged);
+    lock_memory.addListener(this, &ofApp::lockMemoryChanged);
+
+    stream_group.setName("Remote preview");
+    stream_group.add(stream_enabled.set("Enable MJPEG stream", false));
+    stream_group.add(stream_port.set("HTTP port", "8080"));
+    stream_group.add(stream_scale.set("Scale", 0.5f, 0.1f, 1.0f));
+    stream_group.add(stream_fps.set("Stream FPS", 5, 1, 30));
+    stream_group.add(stream_quality.set("JPEG quality", 70, 10, 100));
+    stream_enabled.addListener(this, &ofApp::streamEnabledChanged);
+    stream_port.addListener(this, &ofApp::streamPortChanged);
+
+    recording_group.setName("Recording");
+    recording_group.add(replay_speed.set("Replay speed", 1.0f, 0.1f, 10.0f));
 
     display_settings_group.setName("Display");
     display_settings_group.add(show_webcam_view.set("Show camera preview", true));
     display_settings_group.add(fps.set("FPS", 30, 0, 60));
+    display_settings_group.add(preview_fps.set("Preview FPS", 30, 0, 60));
     display_settings_group.add(show_contours.set("Show contours", true));
     display_settings_group.add(show_trail.set("Show trail", true));
     display_settings_group.add(show_help.set("Show help", false));
@@ -176,6 +309,10 @@ void ofApp::setupGui() {
     gui.add(display_settings_group);
     gui.add(camera_group);
     gui.add(comm_settings_group);
+    gui.add(realtime_group);
+    gui.add(stream_group);
+    gui.add(latency_group);
+    gui.add(recording_group);
     gui.minimizeAll();
 }
 
@@ -199,39 +336,67 @@ void ofApp::updateObjectLocation() {
     }
 }
 
+bool ofApp::updateFrameSource() {
+    if (frame_source.isOpen()) {
+        // Replay the recorded frames at the FPS setting, like the camera would deliver them
+        const auto now = std::chrono::steady_clock::now();
+        if (now < next_replay_time) {
+            return false;
+        }
+        next_replay_time = now + std::chrono::microseconds(fps.get() > 0 ? 1000000 / fps.get() : 0);
+        if (frame_source.update()) {
+            frame_capture_time = std::chrono::steady_clock::now();
+            return true;
+        }
+        ofLog(OF_LOG_NOTICE, "Frame replay finished after " + ofToString(frame_source.getNumFrames()) + " frames.");
+        frame_source.close();
+    }
+
+    if (videoGrabber == nullptr) {
+        return false;
+    }
+    videoGrabber->update();
+    if (!videoGrabber->isFrameNew()) {
+        return false;
+    }
+    // The grabber does not expose the sensor timestamp, so the frame is stamped when it is first seen.
+    frame_capture_time = std::chrono::steady_clock::now();
+    return true;
+}
+
+/**
+ * Updates the smoothed time between tracked frames. Tracking runs at the rate of the camera or the replay,
+ * not at the display rate, so ofGetFrameRate() does not apply here.
+ */
+void ofApp::updateFrameInterval() {
+    const float interval = std::chrono::duration<float>(frame_capture_time - previous_capture_time).count();
+    previous_capture_time = frame_capture_time;
+
+    // Skip the gap after a pause, e.g. when switching between camera and replay
+    if (interval > 0.0f && interval < 0.5f) {
+        frame_interval = 0.9f * frame_interval + 0.1f * interval;
+    }
+}
+
 void ofApp::updateFilterMasks() {
-    rgbm = ofxCv::toCv(*videoGrabber);
+    if (frame_source.isOpen()) {
+        // Wraps the memory-mapped frame, no copy.
+        rgbm = cv::Mat(frame_source.getHeight(), frame_source.getWidth(), CV_8UC3,
+                const_cast<unsigned char *>(frame_source.getPixels()));
+    } else {
+        rgbm = ofxCv::toCv(*videoGrabber);
+    }
 
     // Mirror camera image
     cv::flip(rgbm, rgb, 1);
-    cv::cvtColor(rgb, hsb, cv::COLOR_RGB2HSV_FULL);
 
-    // Add a bit of blur to eliminate camera noise.
-    cv::blur(hsb, hsb, cv::Size(10, 10));
-
-    // Split the hsv image per channel into grayscale images
-    cv::Mat tmp[3];
-    cv::split(hsb, tmp);
-    h = tmp[0];
-    s = tmp[1];
-    b = tmp[2];
+    // Blurred HSV, split per channel into h, s and b
+    ColorFilter::toHsv(rgb, hsb, h, s, b);
 
     // Get the latest tolerance values set by the user
     updateHSVRange();
 
-    cv::inRange(h, Hmin_tol, Hmax_tol, maskH);
-    cv::inRange(s, Smin_tol, Smax_tol, maskS);
-    cv::inRange(b, Vmin_tol, Vmax_tol, maskV);
-
-    // Add all 3 masks with binary AND operation
-    ftr = maskH & maskS & maskV;
-
-    // Fill holes
-    cv::Mat st_elem = getStructuringElement(cv::MORPH_ELLIPSE, cv::Size(5, 5));
-    cv::erode(ftr, ftr, st_elem);
-    cv::dilate(ftr, ftr, st_elem);
-    cv::dilate(ftr, ftr, st_elem);
-    cv::erode(ftr, ftr, st_elem);
+    ColorFilter::filter(h, s, b, Hmin_tol, Hmax_tol, Smin_tol, Smax_tol, Vmin_tol, Vmax_tol, maskH, maskS, maskV, ftr);
 }
 
 void ofApp::updateHSVRange() {
@@ -264,7 +429,7 @@ void ofApp::updateNormalizedObjectLocationInBuffer(ofVec3f v) {
     buffer.at(static_cast<unsigned long>(buffer_position)) = v;
 
     // Set the time delta relative to 30fps instead of actual time delta to prevent underflow of v and a.
-    float dt = ofGetFrameRate() / 30.0f;
+    float dt = frame_interval * 30.0f;
     pos = v;
     vel = (v - vm1) / dt;
     // compute acceleration at t-1, because we do not have a value at t+1 yet.
@@ -274,27 +439,37 @@ void ofApp::updateNormalizedObjectLocationInBuffer(ofVec3f v) {
 //--------------------------------------------------------------
 
 void ofApp::sendOscMessage() {
-    if (pos.x != -1) {
+    if (pos.x != -1 && argmax_area >= 0 && argmax_area < allContours.size()) {
         ofxOscMessage m;
-        m.setAddress(string(msg.get()));
-
-        // position
-        m.addFloatArg(pos.x);
-        m.addFloatArg(pos.y);
-        m.addFloatArg(pos.z);
-
-        // velocity
-        m.addFloatArg(vel.x);
-        m.addFloatArg(vel.y);
-        m.addFloatArg(vel.z);
+        m.setAddress(osc_address);
+
+        // Compute only the features in the schema, for the largest blob only
+        BlobFeatures blob(allContours[argmax_area], mu[argmax_area], rgb, pos, vel, acc);
+        feature_values.resize(static_cast<size_t>(BlobFeatures::schemaSize(osc_features)));
+        float *out = feature_values.data();
+        for (const BlobFeatures::Extractor *feature : osc_features) {
+            feature->compute(blob, out);
+            out += feature->size;
+        }
+        for (float v : feature_values) {
+            m.addFloatArg(v);
+        }
 
-        // accelleration
-        m.addFloatArg(acc.x);
-        m.addFloatArg(acc.y);
-        m.addFloatArg(acc.z);
+        // capture timestamp, microseconds since epoch
+        if (send_capture_timestamp.get()) {
+            m.addInt64Arg(latency_tracer.current().capture_wall_us);
+        }
 
         sender.sendMessage(m, false);
+        latency_tracer.markSent();
         oscMessageSent = true;
+
+        if (loopback_test.get()) {
+            if (!send_capture_timestamp.get()) {
+                m.addInt64Arg(latency_tracer.current().capture_wall_us);
+            }
+            loopback_sender.sendMessage(m, false);
+        }
     } else {
         oscMessageSent = false;
     }
@@ -302,6 +477,174 @@ void ofApp::sendOscMessage() {
 
 //--------------------------------------------------------------
 
+void ofApp::recordTrackerOutput() {
+    if (!tracker_recorder.isOpen()) {
+        return;
+    }
+    tracker_recorder.beginFrame();
+
+    const float p[3] = {pos.x, pos.y, pos.z};
+    const float v[3] = {vel.x, vel.y, vel.z};
+    const float a[3] = {acc.x, acc.y, acc.z};
+    tracker_recorder.appendFrame(p, v, a);
+
+    for (int i = 0; i < allContours.size(); i++) {
+        if (mu[i].m00 > min_area_size.get() && mu[i].m00 < max_area_size.get()) {
+            const ofVec3f c = windowToNorm(ofVec3f(mc[i].x, mc[i].y, static_cast<float>(mu[i].m00)));
+            const float b[3] = {c.x, c.y, c.z};
+            tracker_recorder.appendBlob(i, b);
+        }
+    }
+
+    // The mapper thread could not grow the log, stop recording instead of silently dropping all records
+    if (tracker_recorder.hasFailed()) {
+        ofLog(OF_LOG_ERROR, "Recording tracker output failed: " + tracker_recorder.getError());
+        toggleTrackerRecording();
+    }
+}
+
+void ofApp::toggleTrackerRecording() {
+    if (tracker_recorder.isOpen()) {
+        if (!tracker_recorder.close()) {
+            ofLog(OF_LOG_WARNING, tracker_recorder.getError());
+        }
+        ofLog(OF_LOG_NOTICE, "Stopped recording to " + tracker_recorder.getPath() + ", " +
+                ofToString(tracker_recorder.getNumDroppedRecords()) + " records dropped.");
+    } else {
+        const std::string path = ofToDataPath("tracker-" + ofGetTimestampString("%Y%m%d-%H%M%S") + ".octlog", true);
+        if (tracker_recorder.open(path)) {
+            ofLog(OF_LOG_NOTICE, "Recording tracker output to " + path);
+        } else {
+            ofLog(OF_LOG_ERROR, "Cannot record tracker output: " + tracker_recorder.getError());
+        }
+    }
+}
+
+void ofApp::toggleTrackerReplay() {
+    if (tracker_player.isPlaying()) {
+        tracker_player.stop();
+        ofLog(OF_LOG_NOTICE, "Replay stopped.");
+        return;
+    }
+    // The log only holds position, velocity and acceleration, a receiver trained on another schema would get the wrong inputs.
+    if (BlobFeatures::schemaName(osc_features) != "pos,vel,acc") {
+        ofLog(OF_LOG_WARNING, "Tracker output can only be replayed with OSC schema pos,vel,acc, not " +
+                BlobFeatures::schemaName(osc_features) + ".");
+        return;
+    }
+    // Never replay a log that is still being written.
+    if (tracker_recorder.isOpen()) {
+        toggleTrackerRecording();
+    }
+    const std::string path = findLatestRecording("octlog");
+    if (path.empty()) {
+        ofLog(OF_LOG_WARNING, "No tracker output recordings found in " + ofToDataPath("", true));
+        return;
+    }
+    if (tracker_player.load(path)) {
+        ofLog(OF_LOG_NOTICE, "Replaying " + path + " at " + ofToString(replay_speed.get()) + "x.");
+        tracker_player.play(server.get(), std::stoi(port.get()), msg.get(), replay_speed.get(), getRealtimeOptions());
+    }
+}
+
+void ofApp::toggleFrameRecording() {
+    if (frame_recorder.isOpen()) {
+        if (!frame_recorder.close()) {
+            ofLog(OF_LOG_WARNING, frame_recorder.getError());
+        }
+        ofLog(OF_LOG_NOTICE, "Stopped recording to " + frame_recorder.getPath() + ", " +
+                ofToString(frame_recorder.getNumFrames()) + " frames written, " +
+                ofToString(frame_recorder.getNumDroppedFrames()) + " dropped.");
+        return;
+    }
+    if (videoGrabber == nullptr || !videoGrabber->isInitialized() || frame_source.isOpen()) {
+        ofLog(OF_LOG_WARNING, "Camera frames can only be recorded from a live camera.");
+        return;
+    }
+    const std::string path = ofToDataPath("frames-" + ofGetTimestampString("%Y%m%d-%H%M%S") + ".octraw", true);
+    const int width = static_cast<int>(videoGrabber->getWidth());
+    const int height = static_cast<int>(videoGrabber->getHeight());
+    if (frame_recorder.open(path, width, height, videoGrabber->getPixels().getNumChannels())) {
+        ofLog(OF_LOG_NOTICE, "Recording camera frames to " + path);
+    } else {
+        ofLog(OF_LOG_ERROR, "Cannot record camera frames: " + frame_recorder.getError());
+    }
+}
+
+void ofApp::toggleFrameReplay() {
+    if (frame_source.isOpen()) {
+        frame_source.close();
+        ofLog(OF_LOG_NOTICE, "Frame replay stopped, back to live camera.");
+        return;
+    }
+    // Never replay a recording that is still being written.
+    if (frame_recorder.isOpen()) {
+        toggleFrameRecording();
+    }
+    const std::string path = findLatestRecording("octraw");
+    if (path.empty()) {
+        ofLog(OF_LOG_WARNING, "No camera recordings found in " + ofToDataPath("", true));
+        return;
+    }
+    if (!frame_source.open(path) || frame_source.getChannels() != 3) {
+        frame_source.close();
+        ofLog(OF_LOG_ERROR, "Cannot replay camera frames from " + path);
+        return;
+    }
+    ofLog(OF_LOG_NOTICE, "Replaying " + ofToString(frame_source.getNumFrames()) + " camera frames from " + path);
+}
+
+void ofApp::startCalibrationTuner() {
+    if (calibration_tuner.isRunning()) {
+        calibration_tuner.cancel();
+        ofLog(OF_LOG_NOTICE, "Calibration tuner cancelled.");
+        return;
+    }
+    const std::string clip_path = findLatestRecording("octraw");
+    if (clip_path.empty()) {
+        ofLog(OF_LOG_WARNING, "No camera recordings found in " + ofToDataPath("", true));
+        return;
+    }
+    const std::string labels_path = ofFilePath::removeExt(clip_path) + ".labels";
+    if (calibration_tuner.start(clip_path, labels_path)) {
+        ofLog(OF_LOG_NOTICE, "Tuning calibration against " + clip_path);
+    } else {
+        ofLog(OF_LOG_ERROR, "Cannot read labelled object positions from " + labels_path);
+    }
+}
+
+void ofApp::applyTunerResult(const TunerResult &r) {
+    if (!r.valid) {
+        ofLog(OF_LOG_ERROR, "Calibration tuner found no usable setting, check the recording and labels.");
+        return;
+    }
+    Hmin = r.Hmin;
+    Hmax = r.Hmax;
+    Smin = r.Smin;
+    Smax = r.Smax;
+    Vmin = r.Vmin;
+    Vmax = r.Vmax;
+    tol_h.set(r.tol_h);
+    tol_s.set(r.tol_s);
+    tol_v.set(r.tol_v);
+    sample_radius.set(r.sample_radius);
+    min_area_size.set(r.min_area_size);
+    max_area_size.set(r.max_area_size);
+    updateHSVRange();
+
+    ofLog(OF_LOG_NOTICE, "Tuned calibration values (" + ofToString(r.num_candidates) + " candidates):");
+    ofLog(OF_LOG_NOTICE, "H = [" + std::to_string(Hmin) + ", " + std::to_string(Hmax) + "] +/- " + std::to_string(r.tol_h));
+    ofLog(OF_LOG_NOTICE, "S = [" + std::to_string(Smin) + ", " + std::to_string(Smax) + "] +/- " + std::to_string(r.tol_s));
+    ofLog(OF_LOG_NOTICE, "V = [" + std::to_string(Vmin) + ", " + std::to_string(Vmax) + "] +/- " + std::to_string(r.tol_v));
+    ofLog(OF_LOG_NOTICE, "r = " + std::to_string(r.sample_radius) + ", area = [" +
+            std::to_string(r.min_area_size) + ", " + std::to_string(r.max_area_size) + "]");
+    ofLog(OF_LOG_NOTICE, "detection rate = " + ofToString(r.detection_rate, 3) +
+            ", false positive rate = " + ofToString(r.false_positive_rate, 3) +
+            ", cost = " + ofToString(r.cost_ms, 2) + " ms/frame");
+}
+
+//--------------------------------------------------------------
+
 void ofApp::drawObjectCursor() {
     if (allContours.size() > 0) {
         if (one_blob_only.get() && argmax_area != -1) {
@@ -341,25 +684,6 @@ void ofApp::drawMouseCursor() const {
     ofPopStyle();
 }
 
-void ofApp::drawTrail() {
-
-    int j = 0;
-    ofPushStyle();
-    ofFill();
-    for (int i = buffer_position + buffer_size; i > buffer_position; i--) {
-
-        const unsigned long ii = static_cast<unsigned long>(modn(i, buffer_size));
-        if (buffer.at(ii).x != -1.0) {
-            const ofVec3f v = normToWindow(buffer.at(ii));
-            const float radius = sqrt(v.z) * (buffer_size - j) / (buffer_size);
-            ofSetColor(255, 255, 255, 32 * (buffer_size - j) / buffer_size);
-            ofDrawCircle(v.x, v.y, radius);
-        }
-        j++;
-    }
-    ofPopStyle();
-}
-
 void ofApp::drawStatusMessage(ofVec3f v) {
     ofPushStyle();
     ofFill();
@@ -367,7 +691,9 @@ void ofApp::drawStatusMessage(ofVec3f v) {
     std::string buf =
             "Sending message " + string(msg.get()) +
                     " to " + string(server.get()) +
-                    " on port " + ofToString(port.get()) + " with 9 inputs.";
+                    " on port " + ofToString(port.get()) + " with " +
+                    std::to_string(BlobFeatures::schemaSize(osc_features)) + " inputs" +
+                    (send_capture_timestamp.get() ? " and capture timestamp." : ".");
     ofDrawBitmapString(buf, 10, ofGetWindowHeight() - 55);
     buf = " x = " + ofToString(pos.x, 5, 8, ' ') + ",  y = " + ofToString(pos.y, 5, 8, ' ') + ",  z = " + ofToString(pos.z, 5, 8, ' ');
     ofDrawBitmapString(buf, 10, ofGetWindowHeight() - 40);
@@ -380,12 +706,36 @@ void ofApp::drawStatusMessage(ofVec3f v) {
     ofPopStyle();
 }
 
+void ofApp::drawRecordingMessage() {
+    ofPushStyle();
+    ofSetColor(255, 64, 64, 200);
+    int y = 20;
+    if (tracker_recorder.isOpen()) {
+        ofDrawBitmapString("REC " + ofFilePath::getFileName(tracker_recorder.getPath()), 10, y);
+        y += 15;
+    }
+    if (frame_recorder.isOpen()) {
+        ofDrawBitmapString("REC " + ofFilePath::getFileName(frame_recorder.getPath()) +
+                " (" + ofToString(frame_recorder.getNumDroppedFrames()) + " dropped)", 10, y);
+        y += 15;
+    }
+    if (frame_source.isOpen()) {
+        ofDrawBitmapString("PLAY frame " + ofToString(frame_source.getFrameIndex() + 1) +
+                " / " + ofToString(frame_source.getNumFrames()), 10, y);
+        y += 15;
+    }
+    if (calibration_tuner.isRunning()) {
+        ofDrawBitmapString("TUNING " + ofToString(static_cast<int>(100 * calibration_tuner.getProgress())) + "%", 10, y);
+    }
+    ofPopStyle();
+}
+
 void ofApp::drawHelpPanel() {
 
     int offset = ofGetWindowWidth() / 7;
     int offset2 = offset * 2;
     int line_height = 15;
-    int offset_y = (ofGetWindowHeight() - 11 * line_height) / 2;
+    int offset_y = (ofGetWindowHeight() - 17 * line_height) / 2;
 
     ofPushStyle();
     ofSetColor(0, 0, 0, 128);
@@ -400,7 +750,13 @@ void ofApp::drawHelpPanel() {
     ofDrawBitmapString("[ 3 ] Object trail", ofVec2f(offset2, offset_y + 5 * line_height));
     ofDrawBitmapString("[ s ] Setup panel", ofVec2f(offset2, offset_y + 6 * line_height));
     ofDrawBitmapString("[ c ] Cycle though available cameras", ofVec2f(offset2, offset_y + 7 * line_height));
-    ofDrawBitmapString("[ h ] Help", ofVec2f(offset2, offset_y + 8 * line_height));
+    ofDrawBitmapString("[ r ] Record tracker output", ofVec2f(offset2, offset_y + 8 * line_height));
+    ofDrawBitmapString("[ p ] Replay last recording", ofVec2f(offset2, offset_y + 9 * line_height));
+    ofDrawBitmapString("[ f ] Record camera frames", ofVec2f(offset2, offset_y + 10 * line_height));
+    ofDrawBitmapString("[ v ] Replay last camera recording", ofVec2f(offset2, offset_y + 11 * line_height));
+    ofDrawBitmapString("[ l ] Latency report and trace", ofVec2f(offset2, offset_y + 12 * line_height));
+    ofDrawBitmapString("[ t ] Tune calibration on last recording", ofVec2f(offset2, offset_y + 13 * line_height));
+    ofDrawBitmapString("[ h ] Help", ofVec2f(offset2, offset_y + 14 * line_height));
     ofDrawBitmapString("Version: " + VERSION, ofVec2f(offset2, ofGetWindowHeight() - offset - 4 * line_height));
     ofDrawBitmapString("Author : Gilbert Francois Duivesteijn", ofVec2f(offset2, ofGetWindowHeight() - offset - 3 * line_height));
     ofDrawBitmapString("License: GPLv2", ofVec2f(offset2, ofGetWindowHeight() - offset - 2 * line_height));
@@ -432,6 +788,32 @@ void ofApp::keyPressed(int key) {
             new_id = current_camera_device_id.get() + 1 >= device_list_size ? 0 : current_camera_device_id.get() + 1;
             current_camera_device_id.set(new_id);
             break;
+        case 'r':
+            lock();
+            toggleTrackerRecording();
+            unlock();
+            break;
+        case 'p':
+            lock();
+            toggleTrackerReplay();
+            unlock();
+            break;
+        case 'f':
+            lock();
+            toggleFrameRecording();
+            unlock();
+            break;
+        case 'v':
+            lock();
+            toggleFrameReplay();
+            unlock();
+            break;
+        case 'l':
+            writeLatencyReport();
+            break;
+        case 't':
+            startCalibrationTuner();
+            break;
         case 'h':
             show_help.set(!show_help.get());
             showGui = !show_help.get();
@@ -455,7 +837,9 @@ void ofApp::mouseDragged(int x, int y, int button) {
 }
 
 void ofApp::mousePressed(int x, int y, int button) {
+    lock();
     calibrate(x, y);
+    unlock();
 }
 
 void ofApp::mouseReleased(int x, int y, int button) {
@@ -483,8 +867,11 @@ void ofApp::dragEvent(ofDragInfo dragInfo) {
 }
 
 void ofApp::restartOscSender() {
+    lock();
     sender.clear();
     sender.setup(server.get(), std::stoi(port.get()));
+    osc_address = msg.get();
+    unlock();
 };
 
 void ofApp::serverChanged(std::string &v) {
@@ -502,24 +889,168 @@ void ofApp::msgChanged(std::string &v) {
     ofLog(OF_LOG_NOTICE, "Message changed to " + msg.get());
 };
 
+void ofApp::loopbackTestChanged(bool &v) {
+    restartLoopbackTest();
+}
+
+void ofApp::loopbackPortChanged(std::string &v) {
+    restartLoopbackTest();
+}
+
+void ofApp::restartLoopbackTest() {
+    // The probe has its own lock, only the sender is shared with the tracking thread.
+    // Stopping the probe waits for its thread, so it is done without holding the tracking lock.
+    lock();
+    loopback_sender.clear();
+    unlock();
+    loopback_probe.stop();
+    if (loopback_test.get()) {
+        const int p = std::stoi(loopback_port.get());
+        if (loopback_probe.start(p)) {
+            lock();
+            loopback_sender.setup("127.0.0.1", p);
+            unlock();
+            ofLog(OF_LOG_NOTICE, "Loopback test listening on port " + loopback_port.get());
+        }
+    }
+}
+
+void ofApp::streamEnabledChanged(bool &v) {
+    restartPreviewStream();
+}
+
+void ofApp::streamPortChanged(std::string &v) {
+    restartPreviewStream();
+}
+
+void ofApp::restartPreviewStream() {
+    // submit() never waits for the streamer, so stopping it does not need the tracking lock.
+    preview_streamer.stop();
+    if (stream_enabled.get()) {
+        if (preview_streamer.start(std::stoi(stream_port.get()))) {
+            ofLog(OF_LOG_NOTICE, "Serving MJPEG preview on http://localhost:" + stream_port.get() + "/");
+        } else {
+            ofLog(OF_LOG_ERROR, "Cannot serve MJPEG preview on port " + stream_port.get());
+        }
+    }
+}
+
+void ofApp::writeLatencyReport() {
+    // Report on a copy, so the tracking thread does not wait for the file to be written
+    lock();
+    const LatencyTracer tracer = latency_tracer;
+    unlock();
+
+    ofLog(OF_LOG_NOTICE, tracer.report());
+    const std::string path = ofToDataPath("latency-" + ofGetTimestampString("%Y%m%d-%H%M%S") + ".json", true);
+    if (tracer.writeChromeTrace(path)) {
+        ofLog(OF_LOG_NOTICE, "Chrome trace written to " + path);
+    } else {
+        ofLog(OF_LOG_ERROR, "Cannot write Chrome trace to " + path);
+    }
+}
+
+void ofApp::oscSchemaChanged(std::string &v) {
+    const std::vector<const BlobFeatures::Extractor *> features = BlobFeatures::parseSchema(v);
+    if (features.empty()) {
+        // A message without arguments is useless for the receiver, keep sending the previous schema
+        ofLog(OF_LOG_WARNING, "OSC schema \"" + v + "\" selects no features, keeping " +
+                BlobFeatures::schemaName(osc_features) + ".");
+        osc_schema.set(BlobFeatures::schemaName(osc_features));
+        return;
+    }
+    lock();
+    osc_features = features;
+    unlock();
+    ofLog(OF_LOG_NOTICE, "OSC schema changed to " + v + " with " +
+            std::to_string(BlobFeatures::schemaSize(osc_features)) + " inputs.");
+}
+
+void ofApp::realtimeChanged(int &v) {
+    // Applied by the tracking thread itself, before it processes the next frame
+    realtime_changed = true;
+}
+
+void ofApp::lockMemoryChanged(bool &v) {
+    // Locking now would also pin the memory-mapped files in RAM
+    lock();
+    const bool mapped = tracker_recorder.isOpen() || tracker_player.isPlaying() || frame_recorder.isOpen() ||
+                        frame_source.isOpen() || calibration_tuner.isRunning();
+    unlock();
+    if (v && mapped) {
+        ofLog(OF_LOG_WARNING, "Stop recording, replay and tuning before locking memory.");
+        lock_memory.setWithoutEventNotifications(false);
+        return;
+    }
+    std::string message;
+    if (Realtime::lockMemory(v, message)) {
+        ofLog(OF_LOG_NOTICE, v ? "Memory locked." : "Memory unlocked.");
+    } else {
+        ofLog(OF_LOG_WARNING, message);
+        lock_memory.setWithoutEventNotifications(false);
+    }
+}
+
+RealtimeOptions ofApp::getRealtimeOptions() const {
+    RealtimeOptions options;
+    options.cpu = realtime_cpu.get();
+    options.priority = realtime_priority.get();
+    return options;
+}
+
+/**
+ * Restores the Real-time section saved with the Control Center. Setting the values triggers their listeners,
+ * which apply them. The other sections keep their defaults until they are loaded in the Control Center.
+ */
+void ofApp::loadRealtimeSettings() {
+    ofXml xml;
+    if (!xml.load("settings.xml")) {
+        return;
+    }
+    const ofXml panel = xml.getChild(gui.getParameter().getEscapedName());
+    if (panel) {
+        ofDeserialize(panel, realtime_group);
+    }
+}
+
+void ofApp::applyRealtimeOptions() {
+    // Called on the tracking thread, rendering keeps normal scheduling.
+    std::string message;
+    if (Realtime::applyToCurrentThread(getRealtimeOptions(), message)) {
+        ofLog(OF_LOG_NOTICE, "Tracking thread on CPU " +
+                (realtime_cpu.get() < 0 ? std::string("any") : std::to_string(realtime_cpu.get())) +
+                (realtime_priority.get() > 0 ? " with SCHED_FIFO priority " + std::to_string(realtime_priority.get())
+                                             : std::string(" with normal scheduling")) + ".");
+    } else {
+        ofLog(OF_LOG_WARNING, message);
+    }
+}
+
 void ofApp::fpsChanged(int &v) {
     ofLog(OF_LOG_NOTICE, "FPS value set to " + std::to_string(v) + ".");
     ofSetFrameRate(v);
 }
 
 void ofApp::cameraDeviceIdChanged(int &v) {
+    lock();
+    // A recording holds frames of one camera only
+    if (frame_recorder.isOpen()) {
+        toggleFrameRecording();
+    }
     if (videoGrabber != nullptr) {
         videoGrabber->close();
         delete videoGrabber;
     }
     videoGrabber = new ofVideoGrabber;
     if (current_camera_device_id.get() >= video_device_list.size()) {
-        current_camera_device_id.set(static_cast<int>(video_device_list.size() - 1));
+        current_camera_device_id.setWithoutEventNotifications(static_cast<int>(video_device_list.size() - 1));
     }
     ofLog(OF_LOG_NOTICE, "Camera ID value set to " + std::to_string(v) + ".");
     videoGrabber->setDeviceID(current_camera_device_id.get());
+    videoGrabber->setUseTexture(false);
     videoGrabber->setup(camWidth, camHeight);
     current_camera_device_name.set("", video_device_list[current_camera_device_id.get()].deviceName);
+    unlock();
 }
 
 //--------------------------------------------------------------
@@ -612,6 +1143,18 @@ ofVec3f ofApp::windowToNorm(ofVec3f v) {
     return ofVec3f(x, y, z);
 }
 
+std::string ofApp::findLatestRecording(const std::string &extension) {
+    ofDirectory dir(ofToDataPath(""));
+    dir.allowExt(extension);
+    dir.listDir();
+    if (dir.size() == 0) {
+        return "";
+    }
+    // File names carry a timestamp, so the last one in sorted order is the most recent.
+    dir.sort();
+    return dir.getPath(dir.size() - 1);
+}
+
 int ofApp::modn(int a, int b) {
     // in Python a%b works for negative numbers
     // in C++ use: (b + (a%b)) % b
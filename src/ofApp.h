@@ -9,7 +9,25 @@
 #include "ofxGui.h"
 #include "ofxCv.h"
 
-class ofApp : public ofBaseApp {
+#include "BlobFeatures.h"
+#include "ColorFilter.h"
+#include "CalibrationTuner.h"
+#include "TrackerRecorder.h"
+#include "TrackerPlayer.h"
+#include "FrameRecorder.h"
+#include "FrameFileSource.h"
+#include "LatencyTracer.h"
+#include "LoopbackProbe.h"
+#include "PreviewRenderer.h"
+#include "PreviewStreamer.h"
+#include "Realtime.h"
+
+/**
+ * Tracking and OSC output run on the app's own thread (threadedFunction), rendering and GUI events on the
+ * main thread. The tracking thread holds the ofThread mutex while it processes a frame; the main thread
+ * locks it to read the tracking state or to change what the tracking thread uses.
+ */
+class ofApp : public ofBaseApp, public ofThread {
 
 private:
     const std::string VERSION = "1.1.2";
@@ -38,6 +56,7 @@ private:
 
     ofParameterGroup display_settings_group;
     ofParameter<int> fps;
+    ofParameter<int> preview_fps;
     ofParameter<bool> show_trail;
     ofParameter<bool> show_webcam_view;
     ofParameter<bool> show_contours;
@@ -52,6 +71,47 @@ private:
     ofParameter<std::string> msg;
     ofParameter<std::string> server;
     ofParameter<std::string> port;
+    ofParameter<std::string> osc_schema;
+
+    std::string osc_address;
+    std::vector<const BlobFeatures::Extractor *> osc_features;
+    std::vector<float> feature_values;
+
+    ofParameterGroup realtime_group;
+    ofParameter<int> realtime_cpu;
+    ofParameter<int> realtime_priority;
+    ofParameter<bool> lock_memory;
+    std::atomic<bool> realtime_changed{false};
+
+    ofParameterGroup stream_group;
+    ofParameter<bool> stream_enabled;
+    ofParameter<std::string> stream_port;
+    ofParameter<float> stream_scale;
+    ofParameter<int> stream_fps;
+    ofParameter<int> stream_quality;
+
+    PreviewStreamer preview_streamer;
+
+    ofParameterGroup latency_group;
+    ofParameter<bool> send_capture_timestamp;
+    ofParameter<bool> loopback_test;
+    ofParameter<std::string> loopback_port;
+
+    LatencyTracer latency_tracer;
+    LoopbackProbe loopback_probe;
+    ofxOscSender loopback_sender;
+    std::chrono::steady_clock::time_point frame_capture_time;
+    std::chrono::steady_clock::time_point previous_capture_time;
+    float frame_interval = 1.0f / 30.0f;
+
+    ofParameterGroup recording_group;
+    ofParameter<float> replay_speed;
+
+    TrackerRecorder tracker_recorder;
+    TrackerPlayer tracker_player;
+    FrameRecorder frame_recorder;
+    FrameFileSource frame_source;
+    std::chrono::steady_clock::time_point next_replay_time;
 
     int Hmin = 0;
     int Hmax = 0;
@@ -93,6 +153,9 @@ private:
     ofVec3f vel;
     ofVec3f acc;
 
+    PreviewRenderer preview_renderer;
+    CalibrationTuner calibration_tuner;
+
 
 public:
 
@@ -104,6 +167,8 @@ public:
 
     void draw();
 
+    void threadedFunction() override;
+
     //--------------------------------------------------------------
 
     void setupCamera();
@@ -116,8 +181,14 @@ public:
 
     //--------------------------------------------------------------
 
+    bool updateTracking();
+
     void updateObjectLocation();
 
+    bool updateFrameSource();
+
+    void updateFrameInterval();
+
     void updateFilterMasks();
 
     void updateHSVRange();
@@ -130,20 +201,34 @@ public:
 
     //--------------------------------------------------------------
 
+    void recordTrackerOutput();
+
+    void toggleTrackerRecording();
+
+    void toggleTrackerReplay();
+
+    void toggleFrameRecording();
+
+    void toggleFrameReplay();
+
+    //--------------------------------------------------------------
+
     void drawObjectCursor();
 
     void drawObjectCursorAtPosition(ofVec3f v);
 
     void drawMouseCursor() const;
 
-    void drawTrail();
-
     void drawStatusMessage(ofVec3f v);
 
+    void drawRecordingMessage();
+
     void drawHelpPanel();
 
     //--------------------------------------------------------------
 
+    void exit();
+
     void keyPressed(int key);
 
     void keyReleased(int key);
@@ -172,6 +257,20 @@ public:
 
     void msgChanged(std::string &v);
 
+    void oscSchemaChanged(std::string &v);
+
+    void realtimeChanged(int &v);
+
+    void lockMemoryChanged(bool &v);
+
+    void streamEnabledChanged(bool &v);
+
+    void streamPortChanged(std::string &v);
+
+    void loopbackTestChanged(bool &v);
+
+    void loopbackPortChanged(std::string &v);
+
     void fpsChanged(int &v);
 
     void cameraDeviceIdChanged(int &v);
@@ -180,6 +279,10 @@ public:
 
     void calibrate(int x, int y);
 
+    void startCalibrationTuner();
+
+    void applyTunerResult(const TunerResult &r);
+
     void find_blobs();
 
     //--------------------------------------------------------------
@@ -188,8 +291,22 @@ public:
 
     ofVec3f normToWindow(ofVec3f v);
 
+    std::string findLatestRecording(const std::string &extension);
+
     int modn(int a, int b);
 
     void restartOscSender();
 
+    void restartLoopbackTest();
+
+    RealtimeOptions getRealtimeOptions() const;
+
+    void applyRealtimeOptions();
+
+    void loadRealtimeSettings();
+
+    void restartPreviewStream();
+
+    void writeLatencyReport();
+
 };